@@ -8,3 +8,4 @@ void bench_multisets();
 void bench_partitions();
 void bench_set_partitions();
 void bench_permutations();
+void bench_number_theory();
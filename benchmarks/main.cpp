@@ -57,6 +57,10 @@ int main()
 
     BenchRow::print_line(cout);
 
+    bench_number_theory();
+
+    BenchRow::print_line(cout);
+
     cout << std::defaultfloat;
     cout << "\nTotal Time taken = " << chrono.Peek() << "s" << endl;
 
@@ -21,4 +21,10 @@ void bench_multisets()
     //     cout << ProduceRowReverse("Multisets Stack", MSF);
     cout << ProduceRowConstruct("Multisets", MS, construct);
     //     cout << ProduceRowConstruct("Multisets Stack", MSF, construct);
+
+    auto MSK = discreture::multisets(discreture::multisets::multiset{ms}, 21);
+    cout << ProduceRowForEach("Multisets (size 21)", MSK);
+    cout << ProduceRowForward("Multisets (size 21)", MSK);
+    cout << ProduceRowReverse("Multisets (size 21)", MSK);
+    cout << ProduceRowConstruct("Multisets (size 21)", MSK, construct);
 }
@@ -0,0 +1,62 @@
+#include "Discreture/Misc.hpp"
+#include "Discreture/NumberTheory.hpp"
+#include "Discreture/old/oldstuff.hpp"
+#include "benchmarker.hpp"
+#include "benchtable.hpp"
+#include <cmath>
+#include <thread>
+
+using std::cout;
+
+void bench_number_theory()
+{
+    using discreture::deprecated::PrimeFactorizer;
+
+    const long sieve_n = 10000000;
+    const std::size_t num_threads = std::max(1U, std::thread::hardware_concurrency());
+    std::size_t num_primes = discreture::primes_up_to(sieve_n).size();
+
+    double t = Benchmark([sieve_n]() {
+        PrimeFactorizer P(sieve_n);
+        DoNotOptimize(P.primes);
+    });
+    cout << BenchRow("Old Sieve", t, num_primes);
+
+    t = Benchmark([sieve_n]() { DoNotOptimize(discreture::primes_up_to(sieve_n)); });
+    cout << BenchRow("Segmented Sieve", t, num_primes);
+
+    t = Benchmark([sieve_n, num_threads]() {
+        DoNotOptimize(discreture::primes_up_to(sieve_n, num_threads));
+    });
+    cout << BenchRow("Segmented Sieve w/ " + std::to_string(num_threads) + " threads",
+                     t,
+                     num_primes);
+
+    const long lo = 1000000000;
+    const long count = 200000;
+
+    t = Benchmark([lo, count]() {
+        PrimeFactorizer P(std::sqrt(double(lo + count)) + 1);
+        for (long n = lo; n < lo + count; ++n)
+            DoNotOptimize(P.prime_factorization(n));
+    });
+    cout << BenchRow("Old Factorization", t, count);
+
+    t = Benchmark([lo, count]() {
+        for (long n = lo; n < lo + count; ++n)
+            DoNotOptimize(discreture::factorize(n));
+    });
+    cout << BenchRow("Pollard-Brent Factorization", t, count);
+
+    t = Benchmark([lo, count]() {
+        DoNotOptimize(discreture::factorize_range(lo, lo + count));
+    });
+    cout << BenchRow("Range Factorization", t, count);
+
+    t = Benchmark([lo, count, num_threads]() {
+        DoNotOptimize(discreture::factorize_range(lo, lo + count, num_threads));
+    });
+    cout << BenchRow("Range Factorization w/ " + std::to_string(num_threads) + " threads",
+                     t,
+                     count);
+}
@@ -1,4 +1,6 @@
+#include "Discreture/MultiplicityPartitions.hpp"
 #include "Discreture/Partitions.hpp"
+#include "Discreture/RestrictedPartitions.hpp"
 #include "Discreture/SetPartitions.hpp"
 #include "benchmarker.hpp"
 #include "benchtable.hpp"
@@ -18,6 +20,28 @@ void bench_partitions()
     //     cout << ProduceRowForward("Partitions Stack", PTF);
     cout << ProduceRowReverse("Partitions", PT);
     //     cout << ProduceRowReverse("Partitions Stack", PTF);
+    cout << ProduceRowForEach("Partitions", PT);
+
+    auto MPT = discreture::multiplicity_partitions(npart);
+    cout << ProduceRowForEach("Mult. Partitions", MPT);
+    cout << ProduceRowForward("Mult. Partitions", MPT);
+    double t = Benchmark([&MPT]() {
+        MPT.for_each_parts([](const auto& x) { DoNotOptimize(x); });
+    });
+    cout << BenchRow("Mult. Partitions for_each_parts", t, MPT.size());
+
+    // distinct parts: generated directly, or by filtering all of them
+    auto DPT = discreture::distinct_partitions(npart);
+    cout << ProduceRowForEach("Distinct Partitions", DPT);
+    cout << ProduceRowForward("Distinct Partitions", DPT);
+    t = Benchmark([&PT]() {
+        for (auto&& x : PT)
+        {
+            if (std::adjacent_find(x.begin(), x.end()) == x.end())
+                DoNotOptimize(x);
+        }
+    });
+    cout << BenchRow("Distinct Partitions by filtering", t, DPT.size());
 }
 
 void bench_set_partitions()
@@ -1,3 +1,4 @@
+#include "Discreture/Derangements.hpp"
 #include "Discreture/Permutations.hpp"
 #include "benchmarker.hpp"
 #include "benchtable.hpp"
@@ -19,4 +20,10 @@ void bench_permutations()
     //     cout << ProduceRowReverse("Permutations Stack", PF);
     cout << ProduceRowConstruct("Permutations", P, construct);
     //     cout << ProduceRowConstruct("Permutations Stack", PF, construct);
+
+    auto D = discreture::derangements(nperm);
+    cout << ProduceRowForEach("Derangements", D);
+    cout << ProduceRowForward("Derangements", D);
+    cout << ProduceRowReverse("Derangements", D);
+    cout << ProduceRowConstruct("Derangements", D, construct);
 }
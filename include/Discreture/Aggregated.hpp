@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+namespace discreture
+{
+
+//////////////////////////////////////////
+/// \brief A combination together with an aggregate (sum of weights, xor of
+/// hashes, ...) of its elements.
+//////////////////////////////////////////
+template <class Combination, class T>
+struct aggregated_combination
+{
+    Combination elements;
+    T aggregate;
+};
+
+//////////////////////////////////////////
+/// \brief Lazy container of the combinations of a family, each with an
+/// aggregate of its elements that is kept up to date incrementally.
+///
+/// Instead of recomputing the aggregate of every combination (O(k) each),
+/// whenever the successor changes an element from x to y this calls
+/// remove(aggregate, x) and then add(aggregate, y). Since the successors
+/// change O(1) elements on average, so does this. For it to make sense, add
+/// and remove must be inverses of each other and the order in which elements
+/// are added must not matter (like in an abelian group).
+///
+/// Don't construct this directly, use the aggregated(init, add, remove) member
+/// function of Combinations or LexCombinations.
+///
+/// # Example:
+///
+///     std::vector<double> w = ...; // weights
+///     auto X = combinations(w.size(), 5).aggregated(0.0,
+///         [&w](double& s, int x) { s += w[x]; },
+///         [&w](double& s, int x) { s -= w[x]; });
+///     for (auto&& x : X)
+///         if (x.aggregate > bound)
+///             do_something(x.elements);
+///
+/// With floating point numbers rounding errors do add up a little, so use
+/// something like fixed point if you need exact sums.
+//////////////////////////////////////////
+template <class Combination, class T, class Add, class Remove, class Step>
+class Aggregated
+{
+public:
+    using combination = Combination;
+    using value_type = aggregated_combination<Combination, T>;
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+    class iterator;
+    using const_iterator = iterator;
+
+    Aggregated(Combination first,
+               size_type size,
+               T init,
+               Add add,
+               Remove remove,
+               Step step)
+        : first_(std::move(first))
+        , size_(size)
+        , init_(std::move(init))
+        , add_(std::move(add))
+        , remove_(std::move(remove))
+        , step_(std::move(step))
+    {}
+
+    size_type size() const { return size_; }
+
+    iterator begin() const { return iterator(*this); }
+
+    iterator end() const { return iterator::make_invalid_with_id(size_); }
+
+    class iterator
+        : public boost::iterator_facade<iterator,
+                                        const value_type&,
+                                        boost::forward_traversal_tag>
+    {
+    public:
+        iterator() = default;
+
+        explicit iterator(const Aggregated& A)
+            : ID_(0)
+            , hint_(0)
+            , data_{A.first_, A.init_}
+            , parent_(&A)
+        {
+            if (A.size_ == 0)
+                return;
+
+            for (auto x : data_.elements)
+                A.add_(data_.aggregate, x);
+        }
+
+        size_type ID() const { return ID_; }
+
+        static iterator make_invalid_with_id(size_type id)
+        {
+            iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            if (ID_ >= parent_->size_)
+                return;
+
+            auto& agg = data_.aggregate;
+            const Aggregated& A = *parent_;
+            A.step_(data_.elements, hint_, [&agg, &A](auto from, auto to) {
+                A.remove_(agg, from);
+                A.add_(agg, to);
+            });
+        }
+
+        const value_type& dereference() const { return data_; }
+
+        bool equal(const iterator& other) const { return ID_ == other.ID_; }
+
+        size_type ID_{0};
+        size_type hint_{0};
+        value_type data_{};
+        const Aggregated* parent_{nullptr};
+
+        friend class boost::iterator_core_access;
+    };
+
+private:
+    Combination first_;
+    size_type size_;
+    T init_;
+    Add add_;
+    Remove remove_;
+    Step step_;
+};
+
+} // namespace discreture
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "TimeHelpers.hpp"
+#include "hedley.h"
+
+namespace discreture
+{
+
+//////////////////////////////////////////
+/// \brief The families whose random access iterators have to choose between
+/// stepping one by one and constructing (unranking) from scratch when
+/// advanced.
+//////////////////////////////////////////
+enum class crossover_family : int
+{
+    combinations = 0,
+    combinations_reverse,
+    lex_combinations,
+    lex_combinations_reverse,
+    permutations,
+    permutations_reverse,
+    num_families // keep this one last!
+};
+
+//////////////////////////////////////////
+/// \brief Table of crossover thresholds for iterator::advance.
+///
+/// When an iterator is advanced by m, if |m| < threshold(family, k) it steps
+/// one by one, otherwise it constructs the target from scratch. The right
+/// crossover depends on k and on the CPU, so the first time a (family, k) pair
+/// is needed, the cost of a step is measured against the cost of unranking and
+/// the ratio is stored. A saved profile can be loaded instead, to avoid
+/// measuring at all (or to get reproducible choices).
+///
+/// Usually you don't need to touch this directly: use crossover_table().
+//////////////////////////////////////////
+class CrossoverTable
+{
+public:
+    using difference_type = std::ptrdiff_t;
+
+    // k beyond this (or below 0) just uses the default thresholds.
+    static constexpr difference_type max_k = 62;
+
+    // No need to step more than this, no matter how slow unranking is.
+    static constexpr difference_type max_threshold = 4096;
+
+    static constexpr int num_families =
+      static_cast<int>(crossover_family::num_families);
+
+    //////////////////////////////////////////
+    /// \brief Get the threshold for family and k, calibrating with measure()
+    /// if it has not been set yet.
+    ///
+    /// \param measure should return the measured threshold (see
+    /// measure_crossover). It is only called the first time.
+    //////////////////////////////////////////
+    template <class Measure>
+    difference_type get(crossover_family family, difference_type k, Measure measure)
+    {
+        if (HEDLEY_UNLIKELY(k < 0 || k >= max_k))
+            return default_threshold(family);
+
+        auto& entry = entry_at(family, k);
+        auto t = entry.load(std::memory_order_relaxed);
+
+        if (HEDLEY_LIKELY(t > 0))
+            return t;
+
+        // Two threads might measure at the same time. That's harmless: both
+        // values are reasonable.
+        t = clamp(measure());
+        entry.store(t, std::memory_order_relaxed);
+        return t;
+    }
+
+    //////////////////////////////////////////
+    /// \brief Returns the threshold for family and k without calibrating.
+    /// \return 0 if it has not been calibrated yet.
+    //////////////////////////////////////////
+    difference_type peek(crossover_family family, difference_type k) const
+    {
+        if (k < 0 || k >= max_k)
+            return default_threshold(family);
+
+        return entry_at(family, k).load(std::memory_order_relaxed);
+    }
+
+    void set(crossover_family family, difference_type k, difference_type threshold)
+    {
+        if (k < 0 || k >= max_k)
+            return;
+
+        entry_at(family, k).store(clamp(threshold), std::memory_order_relaxed);
+    }
+
+    //////////////////////////////////////////
+    /// \brief Forget everything. Thresholds will be measured again on use.
+    //////////////////////////////////////////
+    void reset()
+    {
+        for (auto& row : table_)
+            for (auto& entry : row)
+                entry.store(0, std::memory_order_relaxed);
+    }
+
+    //////////////////////////////////////////
+    /// \brief Use the old hardcoded thresholds, never measure anything.
+    //////////////////////////////////////////
+    void use_defaults()
+    {
+        for (int f = 0; f < num_families; ++f)
+        {
+            auto family = static_cast<crossover_family>(f);
+            for (auto& entry : table_[f])
+                entry.store(default_threshold(family), std::memory_order_relaxed);
+        }
+    }
+
+    //////////////////////////////////////////
+    /// \brief Writes every calibrated threshold as lines of the form
+    /// "family k threshold".
+    //////////////////////////////////////////
+    void save(std::ostream& os) const
+    {
+        os << "# discreture crossover profile\n";
+        for (int f = 0; f < num_families; ++f)
+        {
+            for (difference_type k = 0; k < max_k; ++k)
+            {
+                auto t = table_[f][k].load(std::memory_order_relaxed);
+                if (t > 0)
+                    os << family_name(static_cast<crossover_family>(f)) << ' '
+                       << k << ' ' << t << '\n';
+            }
+        }
+    }
+
+    //////////////////////////////////////////
+    /// \brief Reads a profile written by save(). Unknown families and
+    /// malformed lines are ignored.
+    /// \return The number of thresholds read.
+    //////////////////////////////////////////
+    difference_type load(std::istream& is)
+    {
+        difference_type num_read = 0;
+        std::string line;
+        while (std::getline(is, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream ss(line);
+            std::string name;
+            difference_type k = -1;
+            difference_type t = 0;
+
+            if (!(ss >> name >> k >> t))
+                continue;
+
+            for (int f = 0; f < num_families; ++f)
+            {
+                auto family = static_cast<crossover_family>(f);
+                if (name == family_name(family) && k >= 0 && k < max_k)
+                {
+                    set(family, k, t);
+                    ++num_read;
+                }
+            }
+        }
+        return num_read;
+    }
+
+    //////////////////////////////////////////
+    /// \brief The thresholds that were found empirically before calibration
+    /// existed.
+    //////////////////////////////////////////
+    static difference_type default_threshold(crossover_family family)
+    {
+        switch (family)
+        {
+        case crossover_family::combinations: return 40;
+        case crossover_family::lex_combinations: return 30;
+        case crossover_family::permutations_reverse: return 10;
+        default: return 20;
+        }
+    }
+
+    static const char* family_name(crossover_family family)
+    {
+        switch (family)
+        {
+        case crossover_family::combinations: return "combinations";
+        case crossover_family::combinations_reverse:
+            return "combinations_reverse";
+        case crossover_family::lex_combinations: return "lex_combinations";
+        case crossover_family::lex_combinations_reverse:
+            return "lex_combinations_reverse";
+        case crossover_family::permutations: return "permutations";
+        case crossover_family::permutations_reverse:
+            return "permutations_reverse";
+        default: return "unknown";
+        }
+    }
+
+    //////////////////////////////////////////
+    /// \brief The size of the ground set that families should use when
+    /// measuring for a given k. Small enough for every unranking function to be
+    /// well defined, but with many more than a few elements.
+    //////////////////////////////////////////
+    static difference_type sample_n(difference_type k)
+    {
+        difference_type upper = max_k; // no odr-use of max_k (c++14)
+        return std::min(k + 16, upper);
+    }
+
+private:
+    std::array<std::array<std::atomic<difference_type>, max_k>, num_families>
+      table_{};
+
+    std::atomic<difference_type>& entry_at(crossover_family family,
+                                           difference_type k)
+    {
+        return table_[static_cast<int>(family)][k];
+    }
+
+    const std::atomic<difference_type>& entry_at(crossover_family family,
+                                                 difference_type k) const
+    {
+        return table_[static_cast<int>(family)][k];
+    }
+
+    static difference_type clamp(difference_type t)
+    {
+        difference_type upper = max_threshold;
+        return std::max<difference_type>(1, std::min(t, upper));
+    }
+};
+
+//////////////////////////////////////////
+/// \brief The global table of crossover thresholds used by every iterator.
+//////////////////////////////////////////
+inline CrossoverTable& crossover_table()
+{
+    static CrossoverTable table;
+    return table;
+}
+
+//////////////////////////////////////////
+/// \brief Measures how many steps cost the same as one unranking.
+///
+/// \param step advances some internal state by one (it should wrap around by
+/// itself if it reaches the end).
+/// \param unrank takes an int i and constructs some (pseudo-random, depending
+/// on i) element from scratch.
+/// \return ceil(cost of unrank/cost of step)
+//////////////////////////////////////////
+template <class Step, class Unrank>
+std::ptrdiff_t measure_crossover(Step step, Unrank unrank)
+{
+    constexpr int num_steps = 2048;
+    constexpr int num_unranks = 128;
+
+    // warm up
+    step();
+    unrank(0);
+
+    Chronometer C;
+    for (int i = 0; i < num_steps; ++i)
+        step();
+    double step_time = C.Reset()/num_steps;
+
+    for (int i = 0; i < num_unranks; ++i)
+        unrank(i);
+    double unrank_time = C.Peek()/num_unranks;
+
+    if (step_time <= 0.0)
+        return CrossoverTable::max_threshold;
+
+    double ratio = std::ceil(unrank_time/step_time);
+
+    if (ratio > CrossoverTable::max_threshold)
+        return CrossoverTable::max_threshold;
+
+    return std::max<std::ptrdiff_t>(1, static_cast<std::ptrdiff_t>(ratio));
+}
+
+} // namespace discreture
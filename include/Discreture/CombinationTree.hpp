@@ -2,6 +2,10 @@
 
 #include "Misc.hpp"
 #include "VectorHelpers.hpp"
+#include <boost/optional.hpp>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 
 // clang-format off
 /*
@@ -21,6 +25,34 @@
 
 namespace discreture
 {
+namespace detail
+{
+    // Holds a function object, taking no space if it's empty (like a lambda
+    // without captures).
+    template <class F, bool = std::is_empty<F>::value && !std::is_final<F>::value>
+    class ebo_function : private F
+    {
+    public:
+        explicit ebo_function(F f) : F(std::move(f)) {}
+
+        F& function() { return *this; }
+        const F& function() const { return *this; }
+    };
+
+    template <class F>
+    class ebo_function<F, false>
+    {
+    public:
+        explicit ebo_function(F f) : f_(std::move(f)) {}
+
+        F& function() { return f_; }
+        const F& function() const { return f_; }
+
+    private:
+        F f_;
+    };
+} // namespace detail
+
 template <class IntType, class Predicate, class RAContainerInt = std::vector<IntType>>
 class CombinationTree
 {
@@ -47,32 +79,40 @@ public:
     ///
     ////////////////////////////////////////////////////////////
     CombinationTree(IntType n, IntType k, Predicate p)
-        : n_(n), k_(k), begin_(n_, k_, p), end_(p, true), pred_(p)
-    {
-        // 			cout << "In constructor" << endl;
-    }
+        : n_(n), k_(k), begin_(n_, k_, p), end_(p, true)
+    {}
 
     IntType get_n() const { return n_; }
     IntType get_k() const { return k_; }
 
     ////////////////////////////////////////////////////////////
     /// \brief Forward iterator for constructing combinations that satisfy a
-    /// certain predicate one by one
+    /// certain predicate one by one.
+    ///
+    /// An empty predicate (like a lambda without captures) takes no space, and
+    /// the predicate can be passed as std::ref(pred) so that copying iterators
+    /// doesn't copy it. With RAContainerInt a static_vector (see
+    /// find_all_stack), copying an iterator doesn't allocate either.
     ////////////////////////////////////////////////////////////
     class iterator
         : public boost::iterator_facade<iterator, const combination&, boost::forward_traversal_tag>
+        , private detail::ebo_function<Predicate>
     {
     public:
         iterator(Predicate p, bool last)
-            : ID_(0), data_(), at_end_(last), pred_(p)
+            : detail::ebo_function<Predicate>(std::move(p)), data_(), at_end_(last)
         {} // empty initializer
 
         iterator(IntType n, IntType k, Predicate p)
-            : ID_(0), n_(n), k_(k), data_(), at_end_(false), pred_(p)
+            : detail::ebo_function<Predicate>(std::move(p))
+            , n_(n)
+            , k_(k)
+            , data_()
+            , at_end_(false)
         {
             data_.reserve(k_);
 
-            while (DFSUtil(data_, pred_, n_, k_))
+            while (DFSUtil(data_, this->function(), n_, k_))
             {
                 if (data_.size() == static_cast<size_t>(k_))
                 {
@@ -89,15 +129,22 @@ public:
             return at_end_;
         }
 
+        ////////////////////////////////////////////////////////////
+        /// \brief How many combinations came before this one.
+        ////////////////////////////////////////////////////////////
+        size_type ID() const { return ID_; }
+
     private:
         // prefix
         void increment()
         {
-            // 				cout << "size of pred: " << sizeof(pred_) << endl;
-            while (DFSUtil(data_, pred_, n_, k_))
+            while (DFSUtil(data_, this->function(), n_, k_))
             {
                 if (data_.size() == static_cast<size_t>(k_))
+                {
+                    ++ID_;
                     return;
+                }
             }
 
             at_end_ = true;
@@ -105,15 +152,13 @@ public:
 
         const combination& dereference() const { return data_; }
 
+        // Only meaningful for iterators of the same tree, so the ID suffices.
         bool equal(const iterator& it) const
         {
             if (at_end_ != it.at_end_)
                 return false;
 
-            if (at_end_)
-                return true;
-
-            return data_ == it.data_;
+            return at_end_ || ID_ == it.ID_;
         }
 
     private:
@@ -122,7 +167,6 @@ public:
         IntType k_{0};
         combination data_{};
         bool at_end_{true};
-        Predicate pred_;
 
         friend class CombinationTree;
         friend class boost::iterator_core_access;
@@ -138,10 +182,9 @@ private:
     IntType k_;
     iterator begin_;
     iterator end_;
-    Predicate pred_;
 
     static bool augment(combination& comb,
-                        Predicate pred,
+                        Predicate& pred,
                         IntType n_,
                         IntType k_,
                         IntType start = 0)
@@ -175,9 +218,8 @@ private:
         return false;
     }
 
-    static bool DFSUtil(combination& comb, Predicate pred, IntType n_, IntType k_)
+    static bool DFSUtil(combination& comb, Predicate& pred, IntType n_, IntType k_)
     {
-        // 			cout << "n,k = " << n_ << " " << k_ << endl;
         if (comb.size() < static_cast<size_t>(k_))
         {
             if (augment(comb, pred, n_, k_))
@@ -202,4 +244,326 @@ private:
 
 }; // end class CombinationTree
 
+////////////////////////////////////////////////////////////
+/// \brief Like CombinationTree, but with a stateful predicate, so that
+/// checking each node of the tree takes O(1) instead of O(k).
+///
+/// Instead of a predicate that looks at the whole partial combination, this
+/// takes an initial state (the state of the empty combination) and a function
+/// push(const State& s, IntType x) -> boost::optional<State> which returns the
+/// state of the partial combination after appending x, or boost::none if the
+/// branch should be pruned. The iterator keeps one state per depth in a
+/// preallocated stack, so backtracking just discards the top of the stack.
+///
+/// # Example: combinations of {0,...,19} of size 5 whose sum is at most 30
+///
+///     auto push = [](int sum, int x) -> boost::optional<int> {
+///         if (sum + x > 30)
+///             return boost::none;
+///         return sum + x;
+///     };
+///     for (auto&& x : combinations(20,5).find_all(0, push))
+///         cout << x << endl;
+////////////////////////////////////////////////////////////
+template <class IntType,
+          class State,
+          class Push,
+          class RAContainerInt = std::vector<IntType>>
+class StatefulCombinationTree
+{
+public:
+    static_assert(std::is_integral<IntType>::value,
+                  "Template parameter IntType must be integral");
+    static_assert(std::is_signed<IntType>::value,
+                  "Template parameter IntType must be signed");
+    using value_type = RAContainerInt;
+    using combination = value_type;
+    using state_type = State;
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+    class iterator;
+    using const_iterator = iterator;
+
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param n is an integer >= 0
+    /// \param k is an integer with 0 <= k <= n
+    /// \param init is the state of the empty combination
+    /// \param push takes a state and an element x and returns the state after
+    /// appending x, or boost::none to prune.
+    ////////////////////////////////////////////////////////////
+    StatefulCombinationTree(IntType n, IntType k, State init, Push push)
+        : n_(n), k_(k), begin_(n_, k_, init, push), end_(init, push)
+    {}
+
+    IntType get_n() const { return n_; }
+    IntType get_k() const { return k_; }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forward iterator for constructing combinations whose every
+    /// prefix is accepted by push.
+    ////////////////////////////////////////////////////////////
+    class iterator
+        : public boost::iterator_facade<iterator, const combination&, boost::forward_traversal_tag>
+    {
+    public:
+        iterator(State init, Push push) // end iterator
+            : states_(1, std::move(init)), push_(std::move(push))
+        {}
+
+        iterator(IntType n, IntType k, State init, Push push)
+            : n_(n), k_(k), at_end_(false), push_(std::move(push))
+        {
+            data_.reserve(k_);
+            states_.resize(k_ + 1, init);
+            find_next(true);
+        }
+
+        ////////////////////////////////////////////////////////////
+        /// \brief The state after pushing all elements of the current
+        /// combination.
+        ////////////////////////////////////////////////////////////
+        const State& state() const { return states_[data_.size()]; }
+
+        inline bool is_at_end(IntType n) const
+        {
+            UNUSED(n);
+            return at_end_;
+        }
+
+    private:
+        void increment() { find_next(false); }
+
+        const combination& dereference() const { return data_; }
+
+        bool equal(const iterator& it) const
+        {
+            if (at_end_ != it.at_end_)
+                return false;
+
+            if (at_end_)
+                return true;
+
+            return data_ == it.data_;
+        }
+
+        // Tries to append an element >= start which push accepts.
+        bool augment(IntType start)
+        {
+            const IntType d = data_.size();
+            const IntType guysleft = k_ - d;
+
+            if (d > 0)
+                start = std::max(static_cast<IntType>(data_.back() + 1), start);
+
+            for (IntType i = start; i < n_ - guysleft + 1; ++i)
+            {
+                auto new_state = push_(states_[d], i);
+                if (new_state)
+                {
+                    data_.push_back(i);
+                    states_[d + 1] = std::move(*new_state);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Depth first search until the next leaf at depth k.
+        void find_next(bool first_time)
+        {
+            if (k_ == 0)
+            {
+                at_end_ = !first_time;
+                return;
+            }
+
+            bool backtrack = !first_time;
+            while (true)
+            {
+                if (!backtrack && data_.size() < static_cast<size_t>(k_))
+                {
+                    if (augment(0))
+                    {
+                        if (data_.size() == static_cast<size_t>(k_))
+                            return;
+                        continue;
+                    }
+                }
+
+                backtrack = false;
+
+                // replace the last element by the next acceptable one
+                while (true)
+                {
+                    if (data_.empty())
+                    {
+                        at_end_ = true;
+                        return;
+                    }
+
+                    IntType last = data_.back();
+                    data_.pop_back();
+
+                    if (augment(last + 1))
+                        break;
+                }
+
+                if (data_.size() == static_cast<size_t>(k_))
+                    return;
+            }
+        }
+
+    private:
+        IntType n_{0};
+        IntType k_{0};
+        combination data_{};
+        std::vector<State> states_{};
+        bool at_end_{true};
+        Push push_;
+
+        friend class boost::iterator_core_access;
+
+    }; // end class iterator
+
+    const iterator& begin() const { return begin_; }
+
+    const iterator& end() const { return end_; }
+
+private:
+    IntType n_;
+    IntType k_;
+    iterator begin_;
+    iterator end_;
+}; // end class StatefulCombinationTree
+
+namespace detail
+{
+    // Counts the leaves of a StatefulCombinationTree without visiting them,
+    // memoizing the number of completions of a partial combination on
+    // (size, last element, key(state)).
+    template <class IntType, class State, class Push, class Key>
+    class combination_tree_counter
+    {
+    public:
+        using size_type = std::ptrdiff_t;
+        using key_type = std::decay_t<decltype(
+          std::declval<const Key&>()(std::declval<const State&>()))>;
+
+        combination_tree_counter(IntType n, IntType k, const Push& push, const Key& key)
+            : n_(n), k_(k), push_(push), key_(key), memo_(std::max<IntType>(0, k - 1)*n)
+        {}
+
+        // Number of ways to complete a partial combination of size depth
+        // (whose state is s) with elements >= start.
+        size_type count_children(IntType depth, IntType start, const State& s)
+        {
+            size_type total = 0;
+            for (IntType x = start; x < n_ - (k_ - depth) + 1; ++x)
+            {
+                auto t = push_(s, x);
+                if (t)
+                    total += count(depth + 1, x, *t);
+            }
+            return total;
+        }
+
+        // Number of ways to complete a partial combination of size depth
+        // whose last element is last and whose state is s.
+        size_type count(IntType depth, IntType last, const State& s)
+        {
+            if (depth == k_)
+                return 1;
+
+            auto& table = memo_[(depth - 1)*n_ + last];
+            auto h = key_(s);
+            auto it = table.find(h);
+            if (it != table.end())
+                return it->second;
+
+            size_type total = count_children(depth, last + 1, s);
+            table.emplace(std::move(h), total);
+            return total;
+        }
+
+    private:
+        IntType n_;
+        IntType k_;
+        const Push& push_;
+        const Key& key_;
+        std::vector<std::unordered_map<key_type, size_type>> memo_;
+    };
+} // namespace detail
+
+////////////////////////////////////////////////////////////
+/// \brief Counts the combinations of size k of {0,...,n-1} that
+/// StatefulCombinationTree(n, k, init, push) would visit, without visiting
+/// them.
+///
+/// \param key summarizes the state of a partial combination. Two partial
+/// combinations of the same size, with the same last element and whose states
+/// have the same key must have the same number of completions (for example,
+/// if the key is the state itself). Subtree counts are memoized on (size, last
+/// element, key), so if there are few distinct keys this takes polynomial
+/// instead of exponential time. key(state) must be usable as the key of an
+/// std::unordered_map.
+///
+/// \param num_threads splits the work by first element among that many
+/// threads, each with its own memo table. push and key must then be safe to
+/// call concurrently.
+////////////////////////////////////////////////////////////
+template <class IntType, class State, class Push, class Key>
+std::ptrdiff_t count_combination_tree(IntType n,
+                                      IntType k,
+                                      const State& init,
+                                      const Push& push,
+                                      const Key& key,
+                                      size_t num_threads = 1)
+{
+    using counter = detail::combination_tree_counter<IntType, State, Push, Key>;
+
+    if (k < 0 || k > n)
+        return 0;
+
+    if (k == 0)
+        return 1;
+
+    num_threads = std::max<size_t>(1, std::min<size_t>(num_threads, n - k + 1));
+
+    if (num_threads == 1)
+        return counter(n, k, push, key).count_children(0, 0, init);
+
+    // The first few elements have the largest subtrees, so the first elements
+    // are dealt round robin.
+    std::vector<std::ptrdiff_t> partial(num_threads, 0);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+
+    for (size_t i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back([&, i]() {
+            counter C(n, k, push, key);
+            std::ptrdiff_t total = 0;
+            for (IntType x = i; x < n - k + 1; x += IntType(num_threads))
+            {
+                auto t = push(init, x);
+                if (t)
+                    total += C.count(1, x, *t);
+            }
+            partial[i] = total;
+        });
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    std::ptrdiff_t total = 0;
+    for (auto p : partial)
+        total += p;
+    return total;
+}
+
 } // namespace discreture
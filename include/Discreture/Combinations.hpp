@@ -2,15 +2,19 @@
 #include <algorithm>
 #include <numeric>
 
+#include "Aggregated.hpp"
 #include "ArithmeticProgression.hpp"
+#include "Calibration.hpp"
 #include "CombinationTree.hpp"
 #include "IndexedViewContainer.hpp"
 #include "IntegerInterval.hpp"
 #include "LexCombinations.hpp"
 #include "Misc.hpp"
+#include "Probability.hpp"
 #include "Sequences.hpp"
 #include "VectorHelpers.hpp"
 #include "detail/CombinationsDetail.hpp"
+#include "detail/CombinationsSIMD.hpp"
 #include "hedley.h"
 
 namespace discreture
@@ -114,6 +118,44 @@ public:
         return comb;
     }
 
+    ////////////////////////////////////////////////////////////
+    /// \brief A uniformly random combination, using Floyd's algorithm.
+    ///
+    /// Takes O(k) random numbers and never computes an index, so it works
+    /// even if size() does not fit in a size_type.
+    ///
+    /// \param engine is any uniform random bit generator.
+    ////////////////////////////////////////////////////////////
+    template <class Engine>
+    combination random(Engine& engine) const
+    {
+        return random::random_sorted_subset<combination>(n_, k_, engine);
+    }
+
+    combination random() const { return random(random::random_engine()); }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The combinations, each paired with an aggregate of its elements
+    /// that is updated incrementally (see Aggregated).
+    ///
+    /// \param init is the aggregate of the empty combination.
+    /// \param add(T& agg, IntType x) should add x to the aggregate.
+    /// \param remove(T& agg, IntType x) should undo add.
+    ////////////////////////////////////////////////////////////
+    template <class T, class Add, class Remove>
+    auto aggregated(T init, Add add, Remove remove) const
+    {
+        auto step = [](combination& data, size_type& hint, auto on_change) {
+            next_combination_tracked(data, hint, on_change);
+        };
+
+        combination first(k_);
+        std::iota(first.begin(), first.end(), 0);
+
+        return Aggregated<combination, T, Add, Remove, decltype(step)>(
+          std::move(first), size(), std::move(init), add, remove, step);
+    }
+
     ////////////////////////////////////////////////////////////
     /// \brief Get an iterator whose current value is comb
     ///
@@ -200,8 +242,8 @@ public:
             assert(0 <= n + ID_);
 
             // If n is small, it's actually more efficient to just advance to it
-            // one by one. 40 was found empirically
-            if (std::abs(n) < 40)
+            // one by one. Where "small" ends is measured on first use.
+            if (std::abs(n) < crossover_threshold(last_ + 1))
             {
                 while (n > 0)
                 {
@@ -214,6 +256,8 @@ public:
                     decrement();
                     ++n;
                 }
+
+                return;
             }
 
             // If n is large, then it's better to just construct it from
@@ -323,7 +367,7 @@ public:
         {
             assert(0 <= m + ID_);
 
-            if (std::abs(m) < 20)
+            if (std::abs(m) < reverse_crossover_threshold(last_ + 1))
             {
                 while (m > 0)
                 {
@@ -483,6 +527,55 @@ public:
                                                                        pred);
     }
 
+    ///////////////////////////////////////////////
+    /// \brief Like find_all(pred), but the partial combinations are stored in
+    /// a static_vector of capacity MAX_SIZE (which must be at least k), so
+    /// iterators can be copied without allocating.
+    ///
+    /// pred receives a static_vector instead of a combination, so it should
+    /// take its argument as a template (or auto) parameter.
+    /////////////////////////////////////////////
+    template <std::size_t MAX_SIZE = 32, class PartialPredicate>
+    auto find_all_stack(PartialPredicate pred)
+    {
+        assert(static_cast<std::size_t>(k_) <= MAX_SIZE);
+        using boost::container::static_vector;
+        return CombinationTree<IntType,
+                               PartialPredicate,
+                               static_vector<IntType, MAX_SIZE>>(n_, k_, pred);
+    }
+
+    ///////////////////////////////////////////////
+    /// \brief Like find_all(pred), but with a stateful predicate, so that
+    /// checking each partial combination is O(1) instead of O(k). See
+    /// StatefulCombinationTree.
+    ///
+    /// \param init is the state of the empty combination.
+    /// \param push(const State& s, IntType x) should return the state after
+    /// appending x to a partial combination with state s, or boost::none if no
+    /// combination that starts like that should be considered.
+    /////////////////////////////////////////////
+    template <class State, class Push>
+    auto find_all(State init, Push push)
+    {
+        return StatefulCombinationTree<IntType, State, Push, combination>(
+          n_, k_, std::move(init), std::move(push));
+    }
+
+    ///////////////////////////////////////////////
+    /// \brief The number of combinations find_all(init, push) would visit,
+    /// computed without visiting them by memoizing on key(state). See
+    /// count_combination_tree for the requirements on key.
+    /////////////////////////////////////////////
+    template <class State, class Push, class Key>
+    size_type count_all(const State& init,
+                        const Push& push,
+                        const Key& key,
+                        size_t num_threads = 1) const
+    {
+        return count_combination_tree(n_, k_, init, push, key, num_threads);
+    }
+
     ////////////////////////////////////////////////////////////
     /// \brief Applies function f to each element of *this. This is faster than
     /// doing manual iteration up to size 19. After that it falls back on manual
@@ -598,13 +691,21 @@ public:
             data[0] = 0;
             IntType i = 1;
 
-            // 			IntType i = 0;
-
-            for (; i < last && (data[i] + 1 == data[i + 1]); ++i)
+            // Most of the time this stops after one or two elements...
+            const IntType stop = std::min<IntType>(last, IntType(simd_min_size));
+            for (; i < stop && (data[i] + 1 == data[i + 1]); ++i)
             {
                 data[i] = i;
             }
 
+            // ... but if it doesn't, vector registers pay off.
+            if (HEDLEY_UNLIKELY(i == stop && stop < last))
+            {
+                IntType j = first_gap(data, i, last);
+                std::iota(data.begin() + i, data.begin() + j, i);
+                i = j;
+            }
+
             ++data[hint = i];
             return;
         }
@@ -613,6 +714,41 @@ public:
             ++data[0];
     } // next_combination data, hint, last
 
+    //* Same as next_combination, but calls on_change(from, to) for every
+    // element that changes, from old value to new value. */
+    template <class OnChange>
+    static void next_combination_tracked(combination& data,
+                                         size_type& hint,
+                                         OnChange on_change)
+    {
+        const IntType last = data.size() - 1;
+
+        if (HEDLEY_LIKELY(hint > 0))
+        {
+            --hint;
+            on_change(data[hint], data[hint] + 1);
+            ++data[hint];
+            return;
+        }
+
+        if (HEDLEY_UNLIKELY(last < 0))
+            return;
+
+        IntType i = 0;
+        for (; i < last && (data[i] + 1 == data[i + 1]); ++i)
+        {
+            if (data[i] != i)
+            {
+                on_change(data[i], i);
+                data[i] = i;
+            }
+        }
+
+        on_change(data[i], data[i] + 1);
+        ++data[i];
+        hint = i;
+    }
+
     //* This overload returns false if data is the last combination, true
     // otherwise. */
     static bool next_combination(IntType n, combination& data)
@@ -666,7 +802,11 @@ public:
             IntType i = 1;
 
             // Advance i until the first that can decrease: data[i] != i
-            for (; i < last && (data[i] == i); ++i) {}
+            const IntType stop = std::min<IntType>(last, IntType(simd_min_size));
+            for (; i < stop && (data[i] == i); ++i) {}
+
+            if (HEDLEY_UNLIKELY(i == stop && stop < last))
+                i = first_non_fixed(data, i, last);
 
             --data[i];
             --i;
@@ -706,6 +846,28 @@ public:
             data[0] = m;
     }
 
+    ////////////////////////////////////////////////////////////
+    /// \brief The smallest distance for which iterator::advance constructs
+    /// the combination from scratch instead of stepping to it. Measured the
+    /// first time it's needed for each k (see crossover_table()).
+    ////////////////////////////////////////////////////////////
+    static difference_type crossover_threshold(IntType k)
+    {
+        return crossover_table().get(crossover_family::combinations, k, [k]() {
+            return measure_crossover_threshold(k, false);
+        });
+    }
+
+    static difference_type reverse_crossover_threshold(IntType k)
+    {
+        return crossover_table().get(crossover_family::combinations_reverse,
+                                     k,
+                                     [k]() {
+                                         return measure_crossover_threshold(k,
+                                                                            true);
+                                     });
+    }
+
     ///////////////////////////////////////
     /// \brief Combination comparison "less than" operator. Assumes lhs and rhs
     /// have the same size. \return true if lhs would appear before rhs in the
@@ -750,6 +912,113 @@ private:
     IntType k_;
     size_type size_;
 
+    // Scans shorter than this are done with plain loops.
+    static constexpr IntType simd_min_size = 8;
+
+    /////////////////////////////////////
+    /// \brief The first i in [start,last) for which data[i]+1 != data[i+1]
+    /// (or last, if there is none). Uses AVX2/AVX-512 if the CPU has them and
+    /// combination is a contiguous container of 32-bit ints.
+    /////////////////////////////////////
+    static IntType first_gap(const combination& data, IntType start, IntType last)
+    {
+        return first_gap(data,
+                         start,
+                         last,
+                         detail::simd::is_contiguous_int32<combination>{});
+    }
+
+    static IntType first_gap(const combination& data,
+                             IntType start,
+                             IntType last,
+                             std::true_type)
+    {
+        return detail::simd::first_gap(data.data(), start, last);
+    }
+
+    static IntType first_gap(const combination& data,
+                             IntType start,
+                             IntType last,
+                             std::false_type)
+    {
+        IntType i = start;
+        for (; i < last && (data[i] + 1 == data[i + 1]); ++i) {}
+        return i;
+    }
+
+    /////////////////////////////////////
+    /// \brief The first i in [start,last) for which data[i] != i (or last, if
+    /// there is none). Vectorized like first_gap.
+    /////////////////////////////////////
+    static IntType first_non_fixed(const combination& data,
+                                   IntType start,
+                                   IntType last)
+    {
+        return first_non_fixed(data,
+                               start,
+                               last,
+                               detail::simd::is_contiguous_int32<combination>{});
+    }
+
+    static IntType first_non_fixed(const combination& data,
+                                   IntType start,
+                                   IntType last,
+                                   std::true_type)
+    {
+        return detail::simd::first_non_fixed(data.data(), start, last);
+    }
+
+    static IntType first_non_fixed(const combination& data,
+                                   IntType start,
+                                   IntType last,
+                                   std::false_type)
+    {
+        IntType i = start;
+        for (; i < last && (data[i] == i); ++i) {}
+        return i;
+    }
+
+    static difference_type measure_crossover_threshold(IntType k, bool reverse)
+    {
+        if (k < 1)
+            return 1;
+
+        IntType n = CrossoverTable::sample_n(k);
+        IntType last = k - 1;
+        size_type total = binomial<size_type>(n, k);
+        size_type hint = 0;
+        combination data(k);
+        std::iota(data.begin(), data.end(), 0);
+
+        auto step = [&]() {
+            if (!reverse)
+            {
+                next_combination(data, hint, last);
+                if (data.back() == n)
+                {
+                    std::iota(data.begin(), data.end(), 0);
+                    hint = 0;
+                }
+                return;
+            }
+
+            if (data.back() == last)
+                std::iota(data.begin(), data.end(), n - k);
+            else
+                prev_combination(data, last);
+        };
+
+        // Knuth's multiplicative hash, to jump around pseudo-randomly
+        auto unrank = [&](int i) {
+            size_type m = (size_type(i)*2654435761LL)%total;
+            if (reverse)
+                m = binomial<size_type>(n, k) - m - 1;
+            construct_combination(data, m);
+        };
+
+        return measure_crossover(step, unrank);
+    }
+
     template <class P>
     bool augment(combination& comb, P pred, IntType start = 0)
     {
@@ -822,12 +1091,16 @@ auto combinations(IntTypeN n, IntTypeK k)
     return Combinations<SignedInt>(n, k);
 }
 
-template <class Container, class IntType, typename = EnableIfNotIntegral<Container>>
-auto combinations(const Container& X, IntType k)
+// Borrows X if it is an lvalue, takes ownership (without copying) otherwise.
+template <class Container,
+          class IntType,
+          typename = EnableIfNotIntegral<std::decay_t<Container>>>
+auto combinations(Container&& X, IntType k)
 {
     using SignedInt = std::make_signed_t<IntType>;
     using Comb = Combinations<SignedInt>;
-    return indexed_view_container<Container, Comb>(X, Comb(X.size(), k));
+    Comb C(X.size(), k);
+    return indexed_view_container(std::forward<Container>(X), std::move(C));
 }
 
 template <class IntTypeN,
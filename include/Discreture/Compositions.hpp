@@ -0,0 +1,320 @@
+#pragma once
+
+#include "Combinations.hpp"
+#include "Sequences.hpp"
+#include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
+#include <numeric>
+#include <vector>
+
+namespace discreture
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Compositions (ordered partitions) of n: sequences of positive
+/// integers, the parts, that add up to n. Optionally with a given range for
+/// the number of parts and a minimum size for every part.
+///
+/// A composition of n into k parts is given by where its k-1 cuts are among
+/// the n-1 gaps of 1+1+...+1, which is a combination of size k-1 of
+/// {0,...,n-2}. So the compositions with k parts are generated by the
+/// Combinations successor, in the same order (and for the iterator, only the
+/// two parts around each cut that moves are recomputed). Parts of size at
+/// least m are the same as parts of size at least 1 after subtracting m-1
+/// from each one.
+///
+/// Compositions are ordered by number of parts, and then as their cuts.
+///
+/// # Example:
+///
+///     for (auto&& x : compositions(4))
+///         cout << x << ' ';
+///
+/// Prints out:
+///
+///     [ 4 ] [ 1 3 ] [ 2 2 ] [ 3 1 ] [ 1 1 2 ] [ 1 2 1 ] [ 2 1 1 ] [ 1 1 1 1 ]
+////////////////////////////////////////////////////////////
+template <class IntType = int, class RAContainerInt = std::vector<IntType>>
+class Compositions
+{
+public:
+    static_assert(std::is_integral<IntType>::value,
+                  "Template parameter IntType must be integral");
+    static_assert(std::is_signed<IntType>::value,
+                  "Template parameter IntType must be signed");
+    using value_type = RAContainerInt;
+    using composition = value_type;
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+    class iterator;
+    using const_iterator = iterator;
+
+private:
+    using combinations_type = Combinations<IntType>;
+
+    // A composition into k parts and its cuts, with the successor.
+    struct cutter
+    {
+        IntType n;
+        IntType min_part;
+        IntType k{0};
+        IntType r{0}; // n with min_part - 1 taken from each part
+        typename combinations_type::combination cuts;
+        size_type hint{0};
+        composition parts;
+
+        cutter(IntType N, IntType m) : n(N), min_part(m) {}
+
+        void start(IntType num_parts)
+        {
+            k = num_parts;
+            r = n - k*(min_part - 1);
+            cuts.resize(std::max<IntType>(k - 1, 0));
+            std::iota(cuts.begin(), cuts.end(), 0);
+            hint = cuts.size();
+            parts.resize(k);
+            update_parts(0, k - 1);
+        }
+
+        void next()
+        {
+            // Same as Combinations::next_combination, but updating parts.
+            // Most of the time a single cut moves one to the right...
+            if (HEDLEY_LIKELY(hint > 0))
+            {
+                ++cuts[--hint];
+                ++parts[hint];
+                --parts[hint + 1];
+                return;
+            }
+            if (k == 2 || cuts[0] + 1 != cuts[1])
+            {
+                ++cuts[0];
+                ++parts[0];
+                --parts[1];
+                return;
+            }
+
+            // ... otherwise cuts[0..hint) are reset to 0, 1, ..., hint-1 and
+            // cuts[hint] moves right.
+            combinations_type::next_combination(cuts, hint, k - 2);
+            std::fill(parts.begin(), parts.begin() + hint, min_part);
+            update_parts(hint, hint + 1);
+        }
+
+        // recomputes parts[a..b]
+        void update_parts(IntType a, IntType b)
+        {
+            for (IntType j = a; j <= b; ++j)
+            {
+                IntType right = (j < k - 1) ? cuts[j] : r - 1;
+                IntType left = (j > 0) ? cuts[j - 1] : -1;
+                parts[j] = right - left + min_part - 1;
+            }
+        }
+    };
+
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief All the compositions of n.
+    ///
+    /// \param n is an integer >= 0
+    ////////////////////////////////////////////////////////////
+    explicit Compositions(IntType n) : Compositions(n, 0, n) {}
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The compositions of n into exactly k parts.
+    ////////////////////////////////////////////////////////////
+    Compositions(IntType n, IntType k) : Compositions(n, k, k) {}
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The compositions of n with between min_num_parts and
+    /// max_num_parts parts (inclusive), all of them >= min_part.
+    ///
+    /// \param min_part is an integer >= 1
+    ////////////////////////////////////////////////////////////
+    Compositions(IntType n, IntType min_num_parts, IntType max_num_parts, IntType min_part = 1)
+        : n_(n)
+        , min_num_parts_(std::max<IntType>(min_num_parts, 0))
+        , max_num_parts_(std::max<IntType>(max_num_parts, min_num_parts_ - 1))
+        , min_part_(min_part)
+        , offsets_(max_num_parts_ - min_num_parts_ + 2, 0)
+    {
+        assert(min_part >= 1);
+        for (IntType k = min_num_parts_; k <= max_num_parts_; ++k)
+            offsets_[k - min_num_parts_ + 1] =
+              offsets_[k - min_num_parts_] + count(n_, k, min_part_);
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The number of compositions of n into k parts, all >= min_part.
+    ////////////////////////////////////////////////////////////
+    static size_type count(IntType n, IntType k, IntType min_part = 1)
+    {
+        if (k <= 0)
+            return (k == 0 && n == 0) ? 1 : 0;
+        IntType r = n - k*(min_part - 1);
+        if (r < k)
+            return 0;
+        return binomial<size_type>(r - 1, k - 1);
+    }
+
+    size_type size() const { return offsets_.back(); }
+
+    IntType get_n() const { return n_; }
+    IntType get_min_part() const { return min_part_; }
+
+    iterator begin() const
+    {
+        return iterator(n_, first_nonempty(min_num_parts_), max_num_parts_, min_part_);
+    }
+
+    const iterator end() const { return iterator::make_invalid_with_id(size()); }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Access to the m-th composition (slow for iteration)
+    ///
+    /// \param m should be an integer between 0 and size().
+    ////////////////////////////////////////////////////////////
+    composition operator[](size_type m) const
+    {
+        assert(0 <= m && m < size());
+        auto i = std::upper_bound(offsets_.begin(), offsets_.end(), m) - offsets_.begin() - 1;
+        IntType k = min_num_parts_ + i;
+
+        cutter C(n_, min_part_);
+        C.start(k);
+        if (k > 1)
+        {
+            combinations_type::construct_combination(C.cuts, m - offsets_[i]);
+            C.update_parts(0, k - 1);
+        }
+        return C.parts;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Inverse of operator[]: the index of composition x.
+    ////////////////////////////////////////////////////////////
+    size_type get_index(const composition& x) const
+    {
+        IntType k = x.size();
+        assert(min_num_parts_ <= k && k <= max_num_parts_);
+
+        typename combinations_type::combination cuts(std::max<IntType>(k - 1, 0));
+        IntType sum = 0;
+        for (IntType j = 0; j + 1 < k; ++j)
+        {
+            sum += x[j] - (min_part_ - 1);
+            cuts[j] = sum - 1;
+        }
+        return offsets_[k - min_num_parts_] + combinations_type::get_index(cuts);
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Calls f(x) for every composition x, in order. Faster than
+    /// iterating.
+    ////////////////////////////////////////////////////////////
+    template <class Func>
+    void for_each(Func f) const
+    {
+        cutter C(n_, min_part_);
+        for (IntType k = min_num_parts_; k <= max_num_parts_; ++k)
+        {
+            size_type total = count(n_, k, min_part_);
+            if (total == 0)
+                continue;
+
+            C.start(k);
+            f(static_cast<const composition&>(C.parts));
+            for (size_type i = 1; i < total; ++i)
+            {
+                C.next();
+                f(static_cast<const composition&>(C.parts));
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forward iterator class.
+    ////////////////////////////////////////////////////////////
+    class iterator
+        : public boost::iterator_facade<iterator, const composition&, boost::forward_traversal_tag>
+    {
+    public:
+        iterator() = default;
+
+        iterator(IntType n, IntType k, IntType max_num_parts, IntType min_part)
+            : max_num_parts_(max_num_parts), C_(n, min_part)
+        {
+            if (k <= max_num_parts_)
+                start(k);
+        }
+
+        inline size_type ID() const { return ID_; }
+
+        static const iterator make_invalid_with_id(size_type id)
+        {
+            iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            if (ID_ < block_end_)
+            {
+                C_.next();
+                return;
+            }
+
+            // next number of parts with any compositions
+            for (IntType k = C_.k + 1; k <= max_num_parts_; ++k)
+            {
+                if (count(C_.n, k, C_.min_part) > 0)
+                {
+                    start(k);
+                    return;
+                }
+            }
+        }
+
+        void start(IntType k)
+        {
+            C_.start(k);
+            block_end_ = ID_ + count(C_.n, k, C_.min_part);
+        }
+
+        const composition& dereference() const { return C_.parts; }
+
+        bool equal(const iterator& it) const { return it.ID() == ID(); }
+
+    private:
+        size_type ID_{0};
+        size_type block_end_{0};
+        IntType max_num_parts_{0};
+        cutter C_{0, 1};
+
+        friend class boost::iterator_core_access;
+    }; // end class iterator
+
+private:
+    IntType n_;
+    IntType min_num_parts_;
+    IntType max_num_parts_;
+    IntType min_part_;
+    std::vector<size_type> offsets_; // offsets_[i]: before min_num_parts_ + i parts
+
+    IntType first_nonempty(IntType k) const
+    {
+        while (k <= max_num_parts_ && count(n_, k, min_part_) == 0)
+            ++k;
+        return k;
+    }
+
+}; // end class Compositions
+
+using compositions = Compositions<int>;
+
+} // namespace discreture
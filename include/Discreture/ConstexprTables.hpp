@@ -0,0 +1,330 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Sequences and small combinatorial families computed at compile time, as
+// std::array. They can be used in template arguments and static_assert, and
+// indexing them needs no runtime setup at all:
+//
+//     constexpr auto F = compile_time::factorial_table<21>();
+//     static_assert(F[20] == 2432902008176640000LL, "");
+//
+//     // all 56 combinations of size 3 of {0,...,7}, in the same order as
+//     // combinations(8,3)
+//     static constexpr auto C = compile_time::all_combinations<8, 3>();
+//     for (auto& x : C)
+//         do_something(x[0], x[1], x[2]);
+//
+// Notice that (in C++14) std::array's operator[] is only constexpr when the
+// array is const, so store the result in a constexpr variable as above.
+//
+// Tables that overflow are a compile error.
+
+namespace discreture
+{
+namespace compile_time
+{
+    using llint = long long int; // NOLINT: same as in Sequences.hpp
+
+    //////////////////////////////////////////
+    /// \brief n!
+    //////////////////////////////////////////
+    constexpr llint factorial(llint n)
+    {
+        llint result = 1;
+        for (llint i = 2; i <= n; ++i)
+            result *= i;
+        return result;
+    }
+
+    //////////////////////////////////////////
+    /// \brief binomial(n,k), for as long as binomial(n,k)*k fits in an llint.
+    //////////////////////////////////////////
+    constexpr llint binomial(llint n, llint k)
+    {
+        if (k < 0 || k > n)
+            return 0;
+        if (k > n - k)
+            k = n - k;
+        llint result = 1;
+        for (llint i = 0; i < k; ++i)
+            result = result*(n - i)/(i + 1);
+        return result;
+    }
+
+    //////////////////////////////////////////
+    /// \brief The n-th catalan number, for n < 34.
+    //////////////////////////////////////////
+    constexpr llint catalan(llint n)
+    {
+        // C_i = C_{i-1}*2(2i-1)/(i+1), exact at every step
+        llint result = 1;
+        for (llint i = 1; i <= n; ++i)
+            result = result*2*(2*i - 1)/(i + 1);
+        return result;
+    }
+
+    //////////////////////////////////////////
+    /// \brief The n-th motzkin number, for n < 42.
+    //////////////////////////////////////////
+    constexpr llint motzkin(llint n)
+    {
+        llint a = 1; // M_{i-2}
+        llint b = 1; // M_{i-1}
+        for (llint i = 2; i <= n; ++i)
+        {
+            llint c = ((2*i + 1)*b + (3*i - 3)*a)/(i + 2);
+            a = b;
+            b = c;
+        }
+        return b;
+    }
+
+    namespace detail
+    {
+        // Like std::array, but can be modified in a C++14 constexpr function.
+        template <class T, std::size_t N>
+        struct carray
+        {
+            T data[N == 0 ? 1 : N];
+        };
+
+        template <class T, std::size_t N, std::size_t... I>
+        constexpr std::array<T, N> to_std_array(const carray<T, N>& a,
+                                                std::index_sequence<I...>)
+        {
+            return {{a.data[I]...}};
+        }
+
+        template <class T, std::size_t N>
+        constexpr std::array<T, N> to_std_array(const carray<T, N>& a)
+        {
+            return to_std_array(a, std::make_index_sequence<N>{});
+        }
+
+        // Row i of a table of M rows of length K stored row after row.
+        template <class T, std::size_t M, std::size_t K, std::size_t... J>
+        constexpr std::array<T, K>
+        row(const carray<T, M*K>& a, std::size_t i, std::index_sequence<J...>)
+        {
+            return {{a.data[i*K + J]...}};
+        }
+
+        template <class T, std::size_t M, std::size_t K, std::size_t... I>
+        constexpr std::array<std::array<T, K>, M>
+        to_std_array_2d(const carray<T, M*K>& a, std::index_sequence<I...>)
+        {
+            return {{row<T, M, K>(a, I, std::make_index_sequence<K>{})...}};
+        }
+
+        template <class T, std::size_t M, std::size_t K>
+        constexpr std::array<std::array<T, K>, M> to_std_array_2d(const carray<T, M*K>& a)
+        {
+            return to_std_array_2d<T, M, K>(a, std::make_index_sequence<M>{});
+        }
+
+        template <std::size_t N>
+        constexpr carray<llint, N> factorials()
+        {
+            carray<llint, N> F{};
+            for (std::size_t i = 0; i < N; ++i)
+                F.data[i] = (i == 0) ? 1 : F.data[i - 1]*static_cast<llint>(i);
+            return F;
+        }
+
+        template <std::size_t N>
+        constexpr carray<llint, N*N> pascal()
+        {
+            carray<llint, N*N> B{};
+            for (std::size_t n = 0; n < N; ++n)
+            {
+                B.data[n*N] = 1;
+                for (std::size_t k = 1; k <= n; ++k)
+                    B.data[n*N + k] = B.data[(n - 1)*N + k - 1] + B.data[(n - 1)*N + k];
+            }
+            return B;
+        }
+
+        template <std::size_t N>
+        constexpr carray<llint, N> catalans()
+        {
+            carray<llint, N> C{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                auto n = static_cast<llint>(i);
+                C.data[i] = (i == 0) ? 1 : C.data[i - 1]*2*(2*n - 1)/(n + 1);
+            }
+            return C;
+        }
+
+        template <std::size_t N>
+        constexpr carray<llint, N> motzkins()
+        {
+            carray<llint, N> M{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                auto n = static_cast<llint>(i);
+                M.data[i] = (i < 2)
+                  ? 1
+                  : ((2*n + 1)*M.data[i - 1] + (3*n - 3)*M.data[i - 2])/(n + 2);
+            }
+            return M;
+        }
+
+        // Same order as Combinations: colexicographic.
+        template <class IntType, std::size_t N, std::size_t K, std::size_t M>
+        constexpr carray<IntType, M*K> colex_combinations()
+        {
+            carray<IntType, M*K> C{};
+            IntType x[K == 0 ? 1 : K] = {};
+            for (std::size_t j = 0; j < K; ++j)
+                x[j] = static_cast<IntType>(j);
+
+            for (std::size_t i = 0; i < M; ++i)
+            {
+                for (std::size_t j = 0; j < K; ++j)
+                    C.data[i*K + j] = x[j];
+
+                // successor: increase the first element that can be increased
+                // and reset the ones before it
+                std::size_t j = 0;
+                while (j + 1 < K && x[j] + 1 == x[j + 1])
+                    ++j;
+                if (j < K)
+                    ++x[j];
+                for (std::size_t l = 0; l < j; ++l)
+                    x[l] = static_cast<IntType>(l);
+            }
+            return C;
+        }
+
+        // Same order as LexCombinations.
+        template <class IntType, std::size_t N, std::size_t K, std::size_t M>
+        constexpr carray<IntType, M*K> lex_combinations()
+        {
+            carray<IntType, M*K> C{};
+            IntType x[K == 0 ? 1 : K] = {};
+            for (std::size_t j = 0; j < K; ++j)
+                x[j] = static_cast<IntType>(j);
+
+            for (std::size_t i = 0; i < M; ++i)
+            {
+                for (std::size_t j = 0; j < K; ++j)
+                    C.data[i*K + j] = x[j];
+
+                // successor: increase the last element that can be increased
+                // and make the ones after it consecutive
+                std::size_t j = K;
+                while (j > 0 && x[j - 1] == static_cast<IntType>(N - K + j - 1))
+                    --j;
+                if (j == 0)
+                    break;
+                ++x[j - 1];
+                for (std::size_t l = j; l < K; ++l)
+                    x[l] = x[l - 1] + 1;
+            }
+            return C;
+        }
+
+        // Gosper's hack: the next larger number with the same number of bits,
+        // which is the next combination in colexicographic order.
+        template <std::size_t M>
+        constexpr carray<std::uint64_t, M> combination_masks(std::size_t K)
+        {
+            carray<std::uint64_t, M> C{};
+            std::uint64_t x = (K == 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << K) - 1;
+            for (std::size_t i = 0; i < M; ++i)
+            {
+                C.data[i] = x;
+                if (x == 0 || i + 1 == M)
+                    break;
+                std::uint64_t lowest = x & (~x + 1);
+                std::uint64_t ripple = x + lowest;
+                x = (((ripple ^ x) >> 2)/lowest) | ripple;
+            }
+            return C;
+        }
+    } // namespace detail
+
+    //////////////////////////////////////////
+    /// \brief 0!, 1!, ..., (N-1)!
+    //////////////////////////////////////////
+    template <std::size_t N>
+    constexpr std::array<llint, N> factorial_table()
+    {
+        static_assert(N <= 21, "20! is the largest factorial that fits in 64 bits");
+        return detail::to_std_array(detail::factorials<N>());
+    }
+
+    //////////////////////////////////////////
+    /// \brief Pascal's triangle: B[n][k] = binomial(n,k) for n,k < N (0 for
+    /// k > n).
+    //////////////////////////////////////////
+    template <std::size_t N>
+    constexpr std::array<std::array<llint, N>, N> binomial_table()
+    {
+        static_assert(N <= 67, "binomial(67,33) doesn't fit in 64 bits");
+        return detail::to_std_array_2d<llint, N, N>(detail::pascal<N>());
+    }
+
+    //////////////////////////////////////////
+    /// \brief The first N catalan numbers.
+    //////////////////////////////////////////
+    template <std::size_t N>
+    constexpr std::array<llint, N> catalan_table()
+    {
+        static_assert(N <= 34, "the recurrence for C_34 overflows 64 bits");
+        return detail::to_std_array(detail::catalans<N>());
+    }
+
+    //////////////////////////////////////////
+    /// \brief The first N motzkin numbers.
+    //////////////////////////////////////////
+    template <std::size_t N>
+    constexpr std::array<llint, N> motzkin_table()
+    {
+        static_assert(N <= 42, "the recurrence for M_42 overflows 64 bits");
+        return detail::to_std_array(detail::motzkins<N>());
+    }
+
+    //////////////////////////////////////////
+    /// \brief All combinations of size K of {0,...,N-1}, in the same order as
+    /// combinations(N,K).
+    //////////////////////////////////////////
+    template <std::size_t N, std::size_t K, class IntType = int>
+    constexpr std::array<std::array<IntType, K>, binomial(N, K)> all_combinations()
+    {
+        constexpr std::size_t M = binomial(N, K);
+        return detail::to_std_array_2d<IntType, M, K>(
+          detail::colex_combinations<IntType, N, K, M>());
+    }
+
+    //////////////////////////////////////////
+    /// \brief All combinations of size K of {0,...,N-1}, in the same order as
+    /// lex_combinations(N,K).
+    //////////////////////////////////////////
+    template <std::size_t N, std::size_t K, class IntType = int>
+    constexpr std::array<std::array<IntType, K>, binomial(N, K)> all_lex_combinations()
+    {
+        constexpr std::size_t M = binomial(N, K);
+        return detail::to_std_array_2d<IntType, M, K>(
+          detail::lex_combinations<IntType, N, K, M>());
+    }
+
+    //////////////////////////////////////////
+    /// \brief All combinations of size K of {0,...,N-1} as bitmasks (bit i is
+    /// set if i is in the combination), in the same order as
+    /// combinations(N,K), which is increasing order.
+    //////////////////////////////////////////
+    template <std::size_t N, std::size_t K>
+    constexpr std::array<std::uint64_t, binomial(N, K)> all_combination_masks()
+    {
+        static_assert(N <= 64, "masks are 64 bits");
+        return detail::to_std_array(detail::combination_masks<binomial(N, K)>(K));
+    }
+
+} // namespace compile_time
+} // namespace discreture
@@ -0,0 +1,555 @@
+#pragma once
+
+#include "Probability.hpp"
+#include "Sequences.hpp"
+#include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace discreture
+{
+
+////////////////////////////////////////////////////////////
+/// \brief The derangements of {0,1,...,n-1} (permutations without fixed
+/// points) in lexicographic order. More generally, the permutations x with
+/// x[i] != i only for i in a given set of forbidden fixed points.
+///
+/// If j positions are forbidden, there are
+///
+///     D(n,j) = n! - j (n-1)! + binomial(j,2) (n-2)! - ...
+///
+/// of them, and after fixing a prefix the rest are counted by D(m,j') for
+/// the positions and values left, so these numbers (computed on
+/// construction) give size(), operator[] and get_index. The successor is
+/// the one of std::next_permutation, skipping the suffixes that can't be
+/// completed, which is constant amortized. for_each is faster still.
+///
+/// # Example:
+///
+///     derangements X(4);
+///     for (auto&& x : X)
+///         cout << x << ' ';
+///
+/// Prints out:
+///
+///     [ 1 0 3 2 ] [ 1 2 3 0 ] [ 1 3 0 2 ] [ 2 0 3 1 ] [ 2 3 0 1 ]
+///     [ 2 3 1 0 ] [ 3 0 1 2 ] [ 3 2 0 1 ] [ 3 2 1 0 ]
+///
+/// Iterators are random access, so the work can be split with
+/// divide_work_in_equal_parts or parallel_for_each.
+////////////////////////////////////////////////////////////
+template <class IntType = int, class RAContainerInt = std::vector<IntType>>
+class Derangements
+{
+public:
+    static_assert(std::is_integral<IntType>::value,
+                  "Template parameter IntType must be integral");
+    static_assert(std::is_signed<IntType>::value,
+                  "Template parameter IntType must be signed");
+    using value_type = RAContainerInt;
+    using permutation = value_type;
+    using derangement = value_type;
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+    class iterator;
+    using const_iterator = iterator;
+    class reverse_iterator;
+    using const_reverse_iterator = reverse_iterator;
+
+private:
+    // The forbidden fixed points, and D(m,j) for 0 <= j <= m <= n.
+    struct table
+    {
+        IntType n;
+        std::vector<bool> forbidden;
+        std::vector<size_type> D;
+        IntType num_forbidden;
+        size_type size; // D(n, num_forbidden)
+
+        table(IntType N, std::vector<bool> forb)
+            : n(N)
+            , forbidden(std::move(forb))
+            , D((n + 1)*(n + 1), 0)
+            , num_forbidden(std::count(forbidden.begin(), forbidden.end(), true))
+        {
+            // D(m,0) = m!, D(m,j) = D(m,j-1) - D(m-1,j-1)
+            for (IntType m = 0; m <= n; ++m)
+            {
+                D[m*(n + 1)] = factorial(m);
+                for (IntType j = 1; j <= m; ++j)
+                    D[m*(n + 1) + j] = D[m*(n + 1) + j - 1] - D[(m - 1)*(n + 1) + j - 1];
+            }
+            size = count(n, num_forbidden);
+        }
+
+        // permutations of m values into m positions, with j of the
+        // positions whose own value is among them and can't get it
+        size_type count(IntType m, IntType j) const { return D[m*(n + 1) + j]; }
+    };
+
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief The derangements of {0,1,...,n-1}.
+    ///
+    /// \param n is an integer between 0 and 20 (21! doesn't fit in 64 bits).
+    ////////////////////////////////////////////////////////////
+    explicit Derangements(IntType n)
+        : table_(std::make_shared<table>(n, std::vector<bool>(n, true)))
+    {}
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The permutations x of {0,1,...,n-1} with x[i] != i for every i
+    /// in forbidden_fixed_points (the other ones may or may not be fixed).
+    ////////////////////////////////////////////////////////////
+    Derangements(IntType n, const std::vector<IntType>& forbidden_fixed_points)
+        : table_(std::make_shared<table>(n, mask(n, forbidden_fixed_points)))
+    {}
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The number of permutations
+    ///
+    /// \return D(n,j), where j is the number of forbidden fixed points. For
+    /// derangements, the subfactorial !n.
+    ////////////////////////////////////////////////////////////
+    size_type size() const { return table_->size; }
+
+    IntType get_n() const { return table_->n; }
+
+    bool is_forbidden(IntType i) const { return table_->forbidden[i]; }
+
+    iterator begin() const { return iterator(table_); }
+
+    const iterator end() const { return iterator(table_, size()); }
+
+    reverse_iterator rbegin() const { return reverse_iterator(table_); }
+
+    const reverse_iterator rend() const
+    {
+        return reverse_iterator(table_, size());
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Access to the m-th permutation (slow for iteration)
+    ///
+    /// \param m should be an integer between 0 and size().
+    ////////////////////////////////////////////////////////////
+    permutation operator[](size_type m) const
+    {
+        assert(0 <= m && m < size());
+        permutation x(get_n());
+        construct_derangement(x, *table_, m);
+        return x;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Inverse of operator[]: the index of x in lexicographic order.
+    ////////////////////////////////////////////////////////////
+    size_type get_index(const permutation& x) const
+    {
+        const auto& T = *table_;
+        IntType n = get_n();
+        std::vector<bool> used(n, false);
+        IntType j = T.num_forbidden; // positions >= i that can't get their value
+        size_type result = 0;
+        for (IntType i = 0; i < n; ++i)
+        {
+            bool live = T.forbidden[i] && !used[i];
+            for (IntType v = 0; v < x[i]; ++v)
+            {
+                if (used[v] || (v == i && T.forbidden[i]))
+                    continue;
+                result += T.count(n - i - 1, j - live - (v > i && T.forbidden[v]));
+            }
+            used[x[i]] = true;
+            j -= live + (x[i] > i && T.forbidden[x[i]]);
+        }
+        return result;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief A uniformly random permutation of this family.
+    ////////////////////////////////////////////////////////////
+    template <class Engine>
+    permutation random(Engine& engine) const
+    {
+        std::uniform_int_distribution<size_type> d(0, size() - 1);
+        return (*this)[d(engine)];
+    }
+
+    permutation random() const { return random(random::random_engine()); }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Calls f(x) for every permutation x, in order. Faster than
+    /// iterating.
+    ////////////////////////////////////////////////////////////
+    template <class Func>
+    void for_each(Func f) const
+    {
+        IntType n = get_n();
+        permutation x(n);
+        if (n < 2)
+        {
+            if (n == 0 || !is_forbidden(0))
+                f(static_cast<const permutation&>(x));
+            return;
+        }
+
+        // The values not yet used, as a linked list in increasing order:
+        // next[n] is the smallest one and next[v] is the one after v.
+        std::vector<IntType> next(n + 1);
+        std::iota(next.begin(), next.end() - 1, 1);
+        next[n] = 0;
+        for_each(f, x, next, 0);
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Random access iterator class. It's much more efficient as a
+    /// bidirectional iterator than purely random access.
+    ////////////////////////////////////////////////////////////
+    class iterator
+        : public boost::iterator_facade<iterator, const permutation&, boost::random_access_traversal_tag>
+    {
+    public:
+        iterator() = default;
+
+        explicit iterator(std::shared_ptr<const table> T)
+            : data_(T->n), table_(std::move(T))
+        {
+            first_derangement(data_, table_->forbidden);
+        }
+
+        // The id-th permutation, or end() if id is the size
+        iterator(std::shared_ptr<const table> T, size_type id)
+            : ID_(id), data_(T->n), table_(std::move(T))
+        {
+            if (ID_ < table_->size)
+                construct_derangement(data_, *table_, ID_);
+        }
+
+        inline size_type ID() const { return ID_; }
+
+        static const iterator make_invalid_with_id(size_type id)
+        {
+            iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            next_derangement(data_, table_->forbidden);
+        }
+
+        void decrement()
+        {
+            --ID_;
+            if (ID_ == table_->size - 1) // from end()
+                last_derangement(data_, table_->forbidden);
+            else
+                prev_derangement(data_, table_->forbidden);
+        }
+
+        const permutation& dereference() const { return data_; }
+
+        void advance(difference_type m)
+        {
+            assert(0 <= m + ID_);
+            if (std::abs(m) < difference_type(data_.size()))
+            {
+                for (; m > 0; --m)
+                    increment();
+                for (; m < 0; ++m)
+                    decrement();
+                return;
+            }
+
+            ID_ += m;
+            if (ID_ < table_->size) // else end()
+                construct_derangement(data_, *table_, ID_);
+        }
+
+        difference_type distance_to(const iterator& other) const
+        {
+            return static_cast<difference_type>(other.ID()) - ID();
+        }
+
+        bool equal(const iterator& other) const { return ID_ == other.ID_; }
+
+    private:
+        size_type ID_{0};
+        permutation data_{};
+        std::shared_ptr<const table> table_{};
+
+        friend class boost::iterator_core_access;
+    }; // end class iterator
+
+    class reverse_iterator
+        : public boost::iterator_facade<reverse_iterator,
+                                        const permutation&,
+                                        boost::random_access_traversal_tag>
+    {
+    public:
+        reverse_iterator() = default;
+
+        explicit reverse_iterator(std::shared_ptr<const table> T)
+            : data_(T->n), table_(std::move(T))
+        {
+            last_derangement(data_, table_->forbidden);
+        }
+
+        // The id-th permutation from the end, or rend() if id is the size
+        reverse_iterator(std::shared_ptr<const table> T, size_type id)
+            : ID_(id), data_(T->n), table_(std::move(T))
+        {
+            if (ID_ < table_->size)
+                construct_derangement(data_, *table_, table_->size - ID_ - 1);
+        }
+
+        inline size_type ID() const { return ID_; }
+
+        static const reverse_iterator make_invalid_with_id(size_type id)
+        {
+            reverse_iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            prev_derangement(data_, table_->forbidden);
+        }
+
+        void decrement()
+        {
+            --ID_;
+            if (ID_ == table_->size - 1) // from rend()
+                first_derangement(data_, table_->forbidden);
+            else
+                next_derangement(data_, table_->forbidden);
+        }
+
+        const permutation& dereference() const { return data_; }
+
+        void advance(difference_type m)
+        {
+            assert(0 <= m + ID_);
+            if (std::abs(m) < difference_type(data_.size()))
+            {
+                for (; m > 0; --m)
+                    increment();
+                for (; m < 0; ++m)
+                    decrement();
+                return;
+            }
+
+            ID_ += m;
+            if (ID_ < table_->size) // else rend()
+                construct_derangement(data_, *table_, table_->size - ID_ - 1);
+        }
+
+        difference_type distance_to(const reverse_iterator& other) const
+        {
+            return static_cast<difference_type>(other.ID()) - ID();
+        }
+
+        bool equal(const reverse_iterator& other) const { return ID_ == other.ID_; }
+
+    private:
+        size_type ID_{0};
+        permutation data_{};
+        std::shared_ptr<const table> table_{};
+
+        friend class boost::iterator_core_access;
+    }; // end class reverse_iterator
+
+    // **************** Begin static functions
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The next permutation x in lexicographic order with x[i] != i
+    /// whenever forbidden[i]. Like std::next_permutation, returns false
+    /// (and goes back to the first one) if x was the last one.
+    ////////////////////////////////////////////////////////////
+    static bool next_derangement(permutation& x, const std::vector<bool>& forbidden)
+    {
+        return step(x, forbidden, std::less<IntType>());
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The previous permutation, as in next_derangement. Returns false
+    /// (and goes to the last one) if x was the first one.
+    ////////////////////////////////////////////////////////////
+    static bool prev_derangement(permutation& x, const std::vector<bool>& forbidden)
+    {
+        return step(x, forbidden, std::greater<IntType>());
+    }
+
+    static void first_derangement(permutation& x, const std::vector<bool>& forbidden)
+    {
+        std::iota(x.begin(), x.end(), 0);
+        fill(x, forbidden, 0);
+    }
+
+    static void last_derangement(permutation& x, const std::vector<bool>& forbidden)
+    {
+        std::iota(x.rbegin(), x.rend(), 0);
+        fill(x, forbidden, 0);
+    }
+
+    // **************** End static functions
+
+private:
+    std::shared_ptr<const table> table_;
+
+    static std::vector<bool> mask(IntType n, const std::vector<IntType>& points)
+    {
+        std::vector<bool> result(n, false);
+        for (auto i : points)
+        {
+            assert(0 <= i && i < n);
+            result[i] = true;
+        }
+        return result;
+    }
+
+    static void construct_derangement(permutation& x, const table& T, size_type m)
+    {
+        IntType n = T.n;
+        std::vector<bool> used(n, false);
+        IntType j = T.num_forbidden;
+        for (IntType i = 0; i < n; ++i)
+        {
+            bool live = T.forbidden[i] && !used[i];
+            for (IntType v = 0;; ++v)
+            {
+                if (used[v] || (v == i && T.forbidden[i]))
+                    continue;
+                IntType rest = j - live - (v > i && T.forbidden[v]);
+                size_type block = T.count(n - i - 1, rest);
+                if (m < block)
+                {
+                    x[i] = v;
+                    used[v] = true;
+                    j = rest;
+                    break;
+                }
+                m -= block;
+            }
+        }
+    }
+
+    // Can v go in position i and the rest still be completed? Only the
+    // next to last position can go wrong: then last is the value that would
+    // be left for position n-1.
+    static bool fits(const std::vector<bool>& forbidden, IntType n, IntType i, IntType v, IntType last)
+    {
+        if (v == i && forbidden[i])
+            return false;
+        // only one position left: it gets the last value
+        return i != n - 2 || last != n - 1 || !forbidden[n - 1];
+    }
+
+    // x[i..n) is sorted (increasing for the next one, decreasing for the
+    // previous one). Rearranges it into the first valid completion of x[0..i)
+    // in that order: it's sorted, except that a value is swapped with the
+    // next one when it can't go where it is.
+    static void fill(permutation& x, const std::vector<bool>& forbidden, IntType i)
+    {
+        IntType n = x.size();
+        for (; i < n - 2; ++i)
+        {
+            if (x[i] == i && forbidden[i])
+                std::swap(x[i], x[i + 1]);
+        }
+        if (i == n - 2 && !fits(forbidden, n, i, x[i], x[i + 1]))
+            std::swap(x[i], x[i + 1]);
+    }
+
+    // Like std::next_permutation: find the last position i that can get a
+    // value of x[i+1..n) that comes after x[i], put the first such value
+    // there and the first completion after it. Meanwhile, x[i+1..n) is kept
+    // sorted, one insertion at a time, so there are no allocations, and the
+    // cost is proportional to n - i, which is small on average.
+    template <class Compare>
+    static bool step(permutation& x, const std::vector<bool>& forbidden, Compare before)
+    {
+        IntType n = x.size();
+        if (n < 2)
+            return false;
+
+        for (IntType i = n - 2; i >= 0; --i)
+        {
+            IntType val = x[i];
+            auto first = x.begin() + i + 1;
+            auto u = std::upper_bound(first, x.end(), val, before);
+            auto it = u;
+            // only a forbidden fixed point, or position n-2, can skip one
+            while (it != x.end() && !fits(forbidden, n, i, *it, val))
+                ++it;
+
+            if (it != x.end())
+            {
+                x[i] = *it;
+                std::move_backward(u, it, it + 1);
+                *u = val;
+                fill(x, forbidden, i + 1);
+                return true;
+            }
+
+            // insert val in x[i+1..n)
+            std::move(first, u, first - 1);
+            *(u - 1) = val;
+        }
+
+        fill(x, forbidden, 0);
+        return false;
+    }
+
+    template <class Func>
+    void for_each(Func& f, permutation& x, std::vector<IntType>& next, IntType i) const
+    {
+        const auto& T = *table_;
+        IntType n = T.n;
+        if (i == n - 2) // both orders of the last two values
+        {
+            IntType a = next[n];
+            IntType b = next[a];
+            bool forbidden_i = T.forbidden[i];
+            bool forbidden_last = T.forbidden[n - 1];
+            if (!(a == i && forbidden_i) && !(b == n - 1 && forbidden_last))
+            {
+                x[i] = a;
+                x[n - 1] = b;
+                f(static_cast<const permutation&>(x));
+            }
+            if (!(b == i && forbidden_i) && !(a == n - 1 && forbidden_last))
+            {
+                x[i] = b;
+                x[n - 1] = a;
+                f(static_cast<const permutation&>(x));
+            }
+            return;
+        }
+
+        IntType banned = T.forbidden[i] ? i : n;
+        for (IntType prev = n, v = next[n]; v != n; prev = v, v = next[v])
+        {
+            if (v == banned)
+                continue;
+            next[prev] = next[v];
+            x[i] = v;
+            for_each(f, x, next, i + 1);
+            next[prev] = v;
+        }
+    }
+
+}; // end class Derangements
+
+using derangements = Derangements<int>;
+
+} // namespace discreture
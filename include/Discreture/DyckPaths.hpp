@@ -2,6 +2,7 @@
 
 #include "ArithmeticProgression.hpp"
 #include "Misc.hpp"
+#include "Probability.hpp"
 #include "Sequences.hpp"
 #include "VectorHelpers.hpp"
 #include <boost/iterator/iterator_facade.hpp>
@@ -160,6 +161,47 @@ public:
 
     IntType get_n() const { return n_; }
 
+    ////////////////////////////////////////////////////////////
+    /// \brief A uniformly random dyck path, using the cycle lemma.
+    ///
+    /// Shuffles n+1 up steps and n down steps. Exactly one rotation of that
+    /// sequence has all partial sums positive, and removing its first step
+    /// leaves a dyck path. Each path comes from exactly 2n+1 sequences, so it
+    /// is uniform. O(n) time.
+    ///
+    /// \param engine is any uniform random bit generator.
+    ////////////////////////////////////////////////////////////
+    template <class Engine>
+    dyck_path random(Engine& engine) const
+    {
+        const difference_type len = 2*n_ + 1;
+        std::vector<IntType> steps(len, -1);
+        std::fill(steps.begin(), steps.begin() + n_ + 1, 1);
+        std::shuffle(steps.begin(), steps.end(), engine);
+
+        // The rotation starts right after the last minimum of the partial sums
+        difference_type start = 0;
+        difference_type sum = 0;
+        difference_type min_sum = 0;
+        for (difference_type i = 0; i < len; ++i)
+        {
+            sum += steps[i];
+            if (sum <= min_sum)
+            {
+                min_sum = sum;
+                start = i + 1;
+            }
+        }
+
+        dyck_path result(2*n_);
+        for (difference_type i = 1; i < len; ++i)
+            result[i - 1] = steps[(start + i)%len];
+
+        return result;
+    }
+
+    dyck_path random() const { return random(random::random_engine()); }
+
     ////////////////////////////////////////////////////////////
     /// \brief Forward iterator class.
     ////////////////////////////////////////////////////////////
@@ -0,0 +1,560 @@
+#pragma once
+
+#include "Combinations.hpp"
+#include "Sequences.hpp"
+#include "detail/TriangularTable.hpp"
+#include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
+#include <numeric>
+#include <vector>
+
+namespace discreture
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Combinations of size k of {0,...,n-1} whose consecutive elements
+/// are at least d apart.
+///
+/// Subtracting i*(d-1) from the i-th element is a bijection with the
+/// combinations of size k of {0,...,n-(k-1)(d-1)-1}, so this is a view of
+/// that Combinations, in the same order: the successor, operator[],
+/// get_index and reverse iteration are those of Combinations, and only the
+/// elements they change are shifted.
+///
+/// # Example:
+///
+///     for (auto&& x : gapped_combinations(6, 2, 3))
+///         cout << x << ' ';
+///
+/// Prints out:
+///
+///     [ 0 3 ] [ 0 4 ] [ 1 4 ] [ 0 5 ] [ 1 5 ] [ 2 5 ]
+////////////////////////////////////////////////////////////
+template <class IntType = int, class RAContainerInt = std::vector<IntType>>
+class GappedCombinations
+{
+public:
+    static_assert(std::is_integral<IntType>::value,
+                  "Template parameter IntType must be integral");
+    static_assert(std::is_signed<IntType>::value,
+                  "Template parameter IntType must be signed");
+    using value_type = RAContainerInt;
+    using combination = value_type;
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+    class iterator;
+    using const_iterator = iterator;
+    class reverse_iterator;
+    using const_reverse_iterator = reverse_iterator;
+
+private:
+    using base_type = Combinations<IntType, RAContainerInt>;
+
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param n is an integer >= 0
+    /// \param k is an integer >= 0
+    /// \param d is the minimum difference between consecutive elements, >= 1
+    ////////////////////////////////////////////////////////////
+    GappedCombinations(IntType n, IntType k, IntType d)
+        : n_(n), k_(k), d_(d), base_(reduced_n(n, k, d), k)
+    {
+        assert(d >= 1);
+    }
+
+    size_type size() const { return base_.size(); }
+
+    IntType get_n() const { return n_; }
+    IntType get_k() const { return k_; }
+    IntType get_gap() const { return d_; }
+
+    iterator begin() const { return iterator(k_, d_); }
+
+    const iterator end() const { return iterator::make_invalid_with_id(size()); }
+
+    reverse_iterator rbegin() const
+    {
+        return reverse_iterator(size() == 0 ? end() : begin() + (size() - 1));
+    }
+
+    const reverse_iterator rend() const
+    {
+        return reverse_iterator::make_invalid_with_id(size());
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Access to the m-th combination (slow for iteration)
+    ////////////////////////////////////////////////////////////
+    combination operator[](size_type m) const
+    {
+        combination x = base_[m];
+        shift(x, d_);
+        return x;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Inverse of operator[].
+    ////////////////////////////////////////////////////////////
+    size_type get_index(combination x) const
+    {
+        unshift(x, d_);
+        return base_type::get_index(x);
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Calls f(x) for every combination x, in order. Faster than
+    /// iterating.
+    ////////////////////////////////////////////////////////////
+    template <class Func>
+    void for_each(Func f) const
+    {
+        if (d_ == 1)
+        {
+            base_.for_each(f);
+            return;
+        }
+
+        combination x(k_);
+        base_.for_each([&x, &f, this](const combination& y) {
+            for (IntType i = 0; i < k_; ++i)
+                x[i] = y[i] + i*(d_ - 1);
+            f(static_cast<const combination&>(x));
+        });
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Random access iterator class.
+    ////////////////////////////////////////////////////////////
+    class iterator
+        : public boost::iterator_facade<iterator, const combination&, boost::random_access_traversal_tag>
+    {
+    public:
+        iterator() = default;
+
+        iterator(IntType k, IntType d)
+            : last_(k - 1), hint_(k), d_(d), y_(k), x_(k)
+        {
+            std::iota(y_.begin(), y_.end(), 0);
+            x_ = y_;
+            shift(x_, d_);
+        }
+
+        size_type ID() const { return ID_; }
+
+        static iterator make_invalid_with_id(size_type id)
+        {
+            iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            if (last_ < 0)
+                return;
+
+            // Combinations' successor either increases y[hint-1] (and then
+            // hint is one less), or rewrites y[0..hint].
+            bool only_one = hint_ > 0;
+            base_type::next_combination(y_, hint_, last_);
+            if (HEDLEY_LIKELY(only_one) || hint_ == 0)
+            {
+                ++x_[hint_];
+                return;
+            }
+            update(0, hint_);
+        }
+
+        void decrement()
+        {
+            if (ID_ == 0)
+                return;
+            --ID_;
+            hint_ = 0;
+            if (last_ < 0)
+                return;
+
+            if (y_[0] != 0 || last_ == 0)
+            {
+                --y_[0];
+                --x_[0];
+                return;
+            }
+            base_type::prev_combination(y_, last_);
+            update(0, last_);
+        }
+
+        void advance(difference_type m)
+        {
+            if (std::abs(m) <= 1)
+            {
+                if (m == 1)
+                    increment();
+                else if (m == -1)
+                    decrement();
+                return;
+            }
+
+            // from scratch (the index size() gives the same past-the-end
+            // combination as the successor does)
+            ID_ += m;
+            assert(ID_ >= 0);
+            hint_ = 0;
+            base_type::construct_combination(y_, ID_);
+            update(0, last_);
+        }
+
+        difference_type distance_to(const iterator& other) const
+        {
+            return other.ID_ - ID_;
+        }
+
+        bool equal(const iterator& other) const { return ID_ == other.ID_; }
+
+        const combination& dereference() const { return x_; }
+
+        // x[a..b] from y[a..b]
+        void update(IntType a, IntType b)
+        {
+            for (IntType i = a; i <= b; ++i)
+                x_[i] = y_[i] + i*(d_ - 1);
+        }
+
+        size_type ID_{0};
+        IntType last_{-1};
+        size_type hint_{0};
+        IntType d_{1};
+        combination y_{}; // the underlying combination
+        combination x_{};
+
+        friend class boost::iterator_core_access;
+    }; // end class iterator
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Random access iterator class going backwards.
+    ////////////////////////////////////////////////////////////
+    class reverse_iterator
+        : public boost::iterator_facade<reverse_iterator,
+                                        const combination&,
+                                        boost::random_access_traversal_tag>
+    {
+    public:
+        reverse_iterator() = default;
+
+        explicit reverse_iterator(iterator it) : it_(std::move(it)) {}
+
+        size_type ID() const { return ID_; }
+
+        static reverse_iterator make_invalid_with_id(size_type id)
+        {
+            reverse_iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            --it_;
+        }
+
+        void decrement()
+        {
+            --ID_;
+            ++it_;
+        }
+
+        void advance(difference_type m)
+        {
+            ID_ += m;
+            it_ -= m;
+        }
+
+        difference_type distance_to(const reverse_iterator& other) const
+        {
+            return other.ID_ - ID_;
+        }
+
+        bool equal(const reverse_iterator& other) const { return ID_ == other.ID_; }
+
+        const combination& dereference() const { return *it_; }
+
+        size_type ID_{0};
+        iterator it_{};
+
+        friend class boost::iterator_core_access;
+    }; // end class reverse_iterator
+
+private:
+    IntType n_;
+    IntType k_;
+    IntType d_;
+    base_type base_;
+
+    static IntType reduced_n(IntType n, IntType k, IntType d)
+    {
+        if (k == 0)
+            return std::max<IntType>(n, 0);
+        return std::max<IntType>(n - (k - 1)*(d - 1), 0);
+    }
+
+    static void shift(combination& x, IntType d)
+    {
+        for (IntType i = 0; i < IntType(x.size()); ++i)
+            x[i] += i*(d - 1);
+    }
+
+    static void unshift(combination& x, IntType d)
+    {
+        for (IntType i = 0; i < IntType(x.size()); ++i)
+            x[i] -= i*(d - 1);
+    }
+
+}; // end class GappedCombinations
+
+////////////////////////////////////////////////////////////
+/// \brief Combinations of size k of {0,...,n-1} whose consecutive elements
+/// are at most D apart, in lexicographic order.
+///
+/// There's no bijection with plain combinations here, so it counts with a
+/// table f(j,v) of the ways to choose j more elements after v (O(nk) time and
+/// memory on construction), which gives size(), operator[] and get_index.
+/// Every prefix that fits in {0,...,n-1} can be completed (with consecutive
+/// elements), so the successor never backtracks more than it has to.
+///
+/// Counts that don't fit in a size_type are saturated to its maximum, so
+/// size() is exact only while it fits (e.g. max_gap_combinations(120,60,120)
+/// doesn't); iterating and operator[] still work for the indices that fit.
+///
+/// # Example:
+///
+///     for (auto&& x : max_gap_combinations(5, 3, 2))
+///         cout << x << ' ';
+///
+/// Prints out:
+///
+///     [ 0 1 2 ] [ 0 1 3 ] [ 0 2 3 ] [ 0 2 4 ] [ 1 2 3 ] [ 1 2 4 ] [ 1 3 4 ]
+///     [ 2 3 4 ]
+////////////////////////////////////////////////////////////
+template <class IntType = int, class RAContainerInt = std::vector<IntType>>
+class MaxGapCombinations
+{
+public:
+    static_assert(std::is_integral<IntType>::value,
+                  "Template parameter IntType must be integral");
+    static_assert(std::is_signed<IntType>::value,
+                  "Template parameter IntType must be signed");
+    using value_type = RAContainerInt;
+    using combination = value_type;
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+    class iterator;
+    using const_iterator = iterator;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param n is an integer >= 0
+    /// \param k is an integer >= 0
+    /// \param D is the maximum difference between consecutive elements, >= 1
+    ////////////////////////////////////////////////////////////
+    MaxGapCombinations(IntType n, IntType k, IntType D)
+        : n_(std::max<IntType>(n, 0)), k_(k), D_(D), f_(std::max<IntType>(k, 1)*n_, 0)
+    {
+        assert(D >= 1);
+        if (k_ == 0)
+        {
+            size_ = 1;
+            return;
+        }
+
+        // f(0,v) = 1, f(j,v) = f(j-1,v+1) + ... + f(j-1,v+D), with a sliding
+        // window from the right. f(j,v) doesn't increase with v, so once the
+        // window saturates it stays saturated.
+        std::fill(f_.begin(), f_.begin() + n_, 1);
+        for (IntType j = 1; j < k_; ++j)
+        {
+            size_type window = 0;
+            for (IntType v = n_ - 1; v >= 0; --v)
+            {
+                if (window != detail::triangle_overflow)
+                {
+                    if (D_ < n_ - v - 1)
+                        window -= f(j - 1, v + D_ + 1);
+                    window = detail::saturating_add(window, f(j - 1, v + 1));
+                }
+                f_[j*n_ + v] = window;
+            }
+        }
+
+        size_ = 0;
+        for (IntType v = 0; v < n_; ++v)
+            size_ = detail::saturating_add(size_, f(k_ - 1, v));
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The number of combinations (or the largest size_type if it
+    /// doesn't fit).
+    ////////////////////////////////////////////////////////////
+    size_type size() const { return size_; }
+
+    IntType get_n() const { return n_; }
+    IntType get_k() const { return k_; }
+    IntType get_max_gap() const { return D_; }
+
+    iterator begin() const { return iterator(n_, k_, D_); }
+
+    const iterator end() const { return iterator::make_invalid_with_id(size()); }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Access to the m-th combination (slow for iteration)
+    ////////////////////////////////////////////////////////////
+    combination operator[](size_type m) const
+    {
+        assert(0 <= m && m < size());
+        combination x(k_);
+        IntType lo = 0, hi = n_ - 1;
+        for (IntType i = 0; i < k_; ++i)
+        {
+            IntType j = k_ - 1 - i; // elements still to choose after x[i]
+            IntType v = lo;
+            while (m >= f(j, v))
+            {
+                m -= f(j, v);
+                ++v;
+            }
+            assert(v <= hi);
+            x[i] = v;
+            lo = v + 1;
+            hi = std::min<IntType>(v + D_, n_ - 1);
+        }
+        return x;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Inverse of operator[].
+    ////////////////////////////////////////////////////////////
+    size_type get_index(const combination& x) const
+    {
+        size_type result = 0;
+        IntType lo = 0;
+        for (IntType i = 0; i < k_; ++i)
+        {
+            for (IntType v = lo; v < x[i]; ++v)
+                result = detail::saturating_add(result, f(k_ - 1 - i, v));
+            lo = x[i] + 1;
+        }
+        return result;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Calls f(x) for every combination x, in order. Faster than
+    /// iterating.
+    ////////////////////////////////////////////////////////////
+    template <class Func>
+    void for_each(Func f) const
+    {
+        combination x(k_);
+        std::iota(x.begin(), x.end(), 0);
+        for (size_type i = 0; i < size_; ++i)
+        {
+            f(static_cast<const combination&>(x));
+            next_combination(x, n_, D_);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forward iterator class.
+    ////////////////////////////////////////////////////////////
+    class iterator
+        : public boost::iterator_facade<iterator, const combination&, boost::forward_traversal_tag>
+    {
+    public:
+        iterator() = default;
+
+        iterator(IntType n, IntType k, IntType D) : n_(n), D_(D), data_(k)
+        {
+            std::iota(data_.begin(), data_.end(), 0);
+        }
+
+        size_type ID() const { return ID_; }
+
+        static iterator make_invalid_with_id(size_type id)
+        {
+            iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            next_combination(data_, n_, D_);
+        }
+
+        bool equal(const iterator& other) const { return ID_ == other.ID_; }
+
+        const combination& dereference() const { return data_; }
+
+        size_type ID_{0};
+        IntType n_{0};
+        IntType D_{1};
+        combination data_{};
+
+        friend class boost::iterator_core_access;
+    }; // end class iterator
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The next combination in lexicographic order with consecutive
+    /// elements at most D apart. Does nothing useful on the last one.
+    ////////////////////////////////////////////////////////////
+    static void next_combination(combination& x, IntType n, IntType D)
+    {
+        IntType k = x.size();
+        // increase the last element that can be increased, and make the
+        // ones after it consecutive
+        for (IntType i = k - 1; i >= 0; --i)
+        {
+            IntType limit = n - (k - i);
+            if (i > 0)
+                limit = std::min<IntType>(limit, x[i - 1] + D);
+            if (x[i] < limit)
+            {
+                ++x[i];
+                for (IntType j = i + 1; j < k; ++j)
+                    x[j] = x[j - 1] + 1;
+                return;
+            }
+        }
+    }
+
+private:
+    IntType n_;
+    IntType k_;
+    IntType D_;
+    size_type size_{0};
+    std::vector<size_type> f_; // f(j,v) at j*n + v
+
+    size_type f(IntType j, IntType v) const { return v < n_ ? f_[j*n_ + v] : 0; }
+
+}; // end class MaxGapCombinations
+
+template <class IntType>
+auto gapped_combinations(IntType n, IntType k, IntType d)
+{
+    return GappedCombinations<std::make_signed_t<IntType>>(n, k, d);
+}
+
+template <class IntType>
+auto max_gap_combinations(IntType n, IntType k, IntType D)
+{
+    return MaxGapCombinations<std::make_signed_t<IntType>>(n, k, D);
+}
+
+} // namespace discreture
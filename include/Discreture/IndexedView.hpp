@@ -1,6 +1,8 @@
 #pragma once
 #include "Misc.hpp"
 #include "TemplateHelpers.hpp"
+#include "detail/Gather.hpp"
+#include <algorithm>
 
 namespace discreture
 {
@@ -18,6 +20,10 @@ public:
     using ContainerUnderlying = std::remove_reference_t<RAContainer>;
     using IndexContainerUnderlying = std::remove_reference_t<RAIndexContainer>;
     using value_type = typename ContainerUnderlying::value_type;
+    // Whatever the container's operator[] returns: usually const value_type&,
+    // but it can be a proxy (like the records of an SoAView).
+    using reference =
+      decltype(std::declval<const ContainerUnderlying&>()[std::ptrdiff_t(0)]);
     using size_type = std::ptrdiff_t;
     using difference_type = size_type;
     class iterator;
@@ -34,19 +40,47 @@ public:
 
     size_type size() const { return indices_.size(); }
 
-    const value_type& operator[](difference_type m) const
+    const ContainerUnderlying& objects() const { return objects_; }
+
+    const IndexContainerUnderlying& indices() const { return indices_; }
+
+    reference operator[](difference_type m) const
     {
         return objects_[indices_[m]];
     }
 
+    ///////////////////////////////////////////////
+    /// \brief Copies the elements of the view (in order) to out, which must
+    /// have room for size() elements.
+    ///
+    /// If out is a pointer, both containers are contiguous and the elements
+    /// are trivially copyable, this is a gather: AVX2 gather instructions for
+    /// 4 and 8 byte arithmetic types (with int indices) and memcpy for any
+    /// other trivially copyable record. Otherwise, it is a simple copy.
+    ///
+    /// \return out advanced by size().
+    ///////////////////////////////////////////////
+    template <class OutputIt>
+    OutputIt materialize_into(OutputIt out) const
+    {
+        using can_gather = std::integral_constant<
+          bool,
+          std::is_same<OutputIt, value_type*>::value &&
+            std::is_trivially_copyable<value_type>::value &&
+            detail::has_contiguous_data<ContainerUnderlying>::value &&
+            detail::has_contiguous_data<IndexContainerUnderlying>::value>;
+
+        return materialize_into(out, can_gather{});
+    }
+
     class iterator
-        : public boost::iterator_facade<iterator, const value_type&, boost::random_access_traversal_tag>
+        : public boost::iterator_facade<iterator, value_type, boost::random_access_traversal_tag, reference>
     {
     public:
         using index_iter =
           typename std::remove_reference_t<RAIndexContainer>::const_iterator;
 
-        iterator(const RAContainer& objects, const index_iter& index)
+        iterator(const ContainerUnderlying& objects, const index_iter& index)
             : index_iter_(index), objects_(objects)
         {}
 
@@ -57,7 +91,7 @@ public:
 
         void advance(difference_type m) { std::advance(index_iter_, m); }
 
-        const value_type& dereference() const { return objects_[*index_iter_]; }
+        reference dereference() const { return objects_[*index_iter_]; }
 
         bool equal(const iterator& other) const
         {
@@ -71,12 +105,24 @@ public:
 
     private:
         index_iter index_iter_;
-        const RAContainer& objects_;
+        const ContainerUnderlying& objects_;
 
         friend class boost::iterator_core_access;
     };
 
 private:
+    template <class OutputIt>
+    OutputIt materialize_into(OutputIt out, std::false_type) const
+    {
+        return std::copy(begin(), end(), out);
+    }
+
+    value_type* materialize_into(value_type* out, std::true_type) const
+    {
+        detail::gather(objects_.data(), indices_.data(), size(), out);
+        return out + size();
+    }
+
     add_const_to_value_t<RAContainer> objects_;
     add_const_to_value_t<RAIndexContainer> indices_;
 };
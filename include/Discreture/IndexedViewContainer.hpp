@@ -1,5 +1,6 @@
 #pragma once
 #include "IndexedView.hpp"
+#include "TemplateHelpers.hpp"
 #include "VectorHelpers.hpp"
 #include <unordered_map>
 
@@ -36,17 +37,23 @@ template <class Container, class ContainerOfIndexContainers>
 class IndexedViewContainer
 {
 public:
+    // Lvalues are borrowed (stored as const references) and rvalues are owned
+    // (moved in), so constructing one of these never copies the objects.
+    using Objects = std::remove_cv_t<std::remove_reference_t<Container>>;
+    using IndexContainers =
+      std::remove_cv_t<std::remove_reference_t<ContainerOfIndexContainers>>;
     using difference_type = std::ptrdiff_t;
     using size_type = difference_type;
-    using indices = typename ContainerOfIndexContainers::value_type;
+    using indices = typename IndexContainers::value_type;
     using index = typename indices::value_type;
-    using value_type = IndexedView<const Container&, const indices&>;
+    using value_type = IndexedView<const Objects&, const indices&>;
     class iterator;
     using const_iterator = iterator;
 
 public:
-    IndexedViewContainer(Container objects, ContainerOfIndexContainers indices)
-        : objects_(std::move(objects)), indices_(std::move(indices))
+    IndexedViewContainer(Container&& objects, ContainerOfIndexContainers&& indices)
+        : objects_(std::forward<Container>(objects))
+        , indices_(std::forward<ContainerOfIndexContainers>(indices))
     {}
 
     size_type size() const { return indices_.size(); }
@@ -60,6 +67,32 @@ public:
         return indexed_view(objects_, indices_[i]);
     }
 
+    ////////////////////////////////////
+    /// \brief Writes the elements of views first, first+1, ...,
+    /// first+count-1 one after the other to out (with IndexedView's
+    /// materialize_into, so it's a gather whenever possible).
+    ///
+    /// The index containers are visited with an iterator, so for
+    /// combinatorial families this steps from one to the next instead of
+    /// unranking each one.
+    ///
+    /// \return out advanced by the total number of elements written.
+    ////////////////////////////////////
+    template <class OutputIt>
+    OutputIt materialize_into(OutputIt out, size_type first, size_type count) const
+    {
+        auto it = begin() + first;
+        for (size_type i = 0; i < count; ++i, ++it)
+            out = (*it).materialize_into(out);
+        return out;
+    }
+
+    template <class OutputIt>
+    OutputIt materialize_into(OutputIt out) const
+    {
+        return materialize_into(out, 0, size());
+    }
+
     class iterator
         : public boost::iterator_facade<iterator,
                                         value_type,
@@ -67,10 +100,9 @@ public:
                                         value_type>
     {
     public:
-        using indices_iterator =
-          typename ContainerOfIndexContainers::const_iterator;
+        using indices_iterator = typename IndexContainers::const_iterator;
 
-        iterator(const Container& objects, indices_iterator indices_iter)
+        iterator(const Objects& objects, indices_iterator indices_iter)
             : objects_(objects), indices_(std::move(indices_iter))
         {}
 
@@ -99,24 +131,29 @@ public:
         const indices_iterator& get_index_iterator() const { return indices_; }
 
     private:
-        const Container& objects_;
+        const Objects& objects_;
         indices_iterator indices_;
         friend class boost::iterator_core_access;
     };
 
 private:
-    Container objects_; // TODO(mraggi): make this use the move-or-reference
-                        // idiom.
-    ContainerOfIndexContainers indices_; // TODO(mraggi): make this use the
-                                         // move-or-reference idiom.
+    add_const_to_value_t<Container> objects_;
+    add_const_to_value_t<ContainerOfIndexContainers> indices_;
 };
 
+#if __cplusplus >= 201703L
+// deduction guide only for c++17 :(
+template <class Container, class ContainerOfIndexContainers>
+IndexedViewContainer(Container&&, ContainerOfIndexContainers &&)
+  ->IndexedViewContainer<Container, ContainerOfIndexContainers>;
+#endif
+
 // deprecated in C++17, but useful for C++14
 template <class Container, class ContainerOfIndexContainers>
-auto indexed_view_container(const Container& A,
-                            const ContainerOfIndexContainers& I)
+auto indexed_view_container(Container&& A, ContainerOfIndexContainers&& I)
 {
-    return IndexedViewContainer<Container, ContainerOfIndexContainers>(A, I);
+    return IndexedViewContainer<Container, ContainerOfIndexContainers>(
+      std::forward<Container>(A), std::forward<ContainerOfIndexContainers>(I));
 }
 
 } // namespace discreture
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "Aggregated.hpp"
 #include "ArithmeticProgression.hpp"
+#include "Calibration.hpp"
 #include "CombinationTree.hpp"
 #include "IndexedViewContainer.hpp"
 #include "Misc.hpp"
+#include "Probability.hpp"
 #include "Sequences.hpp"
 #include "VectorHelpers.hpp"
 #include "detail/LexCombinationsDetail.hpp"
@@ -98,6 +101,45 @@ public:
         return comb;
     }
 
+    ////////////////////////////////////////////////////////////
+    /// \brief A uniformly random combination, using Floyd's algorithm.
+    ///
+    /// Takes O(k) random numbers and never computes an index, so it works
+    /// even if size() does not fit in a size_type.
+    ///
+    /// \param engine is any uniform random bit generator.
+    ////////////////////////////////////////////////////////////
+    template <class Engine>
+    combination random(Engine& engine) const
+    {
+        return random::random_sorted_subset<combination>(n_, k_, engine);
+    }
+
+    combination random() const { return random(random::random_engine()); }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The combinations, each paired with an aggregate of its elements
+    /// that is updated incrementally (see Aggregated).
+    ///
+    /// \param init is the aggregate of the empty combination.
+    /// \param add(T& agg, IntType x) should add x to the aggregate.
+    /// \param remove(T& agg, IntType x) should undo add.
+    ////////////////////////////////////////////////////////////
+    template <class T, class Add, class Remove>
+    auto aggregated(T init, Add add, Remove remove) const
+    {
+        IntType n = n_;
+        auto step = [n](combination& data, size_type& /*hint*/, auto on_change) {
+            next_combination_tracked(data, n, on_change);
+        };
+
+        combination first(k_);
+        std::iota(first.begin(), first.end(), 0);
+
+        return Aggregated<combination, T, Add, Remove, decltype(step)>(
+          std::move(first), size(), std::move(init), add, remove, step);
+    }
+
     size_type get_index(const combination& comb) const
     {
         return get_index(comb, n_);
@@ -182,7 +224,7 @@ public:
             assert(0 <= n + ID_);
 
             // If n is small, it's actually more efficient to just iterate to it
-            if (std::abs(n) < 30)
+            if (std::abs(n) < crossover_threshold(k_))
             {
                 while (n > 0)
                 {
@@ -283,7 +325,7 @@ public:
         {
             assert(0 <= m + ID_);
 
-            if (std::abs(m) < 20)
+            if (std::abs(m) < reverse_crossover_threshold(data_.size()))
             {
                 while (m > 0)
                 {
@@ -453,6 +495,55 @@ public:
                                                                           pred);
     }
 
+    ///////////////////////////////////////////////
+    /// \brief Like find_all(pred), but the partial combinations are stored in
+    /// a static_vector of capacity MAX_SIZE (which must be at least k), so
+    /// iterators can be copied without allocating.
+    ///
+    /// pred receives a static_vector instead of a combination, so it should
+    /// take its argument as a template (or auto) parameter.
+    /////////////////////////////////////////////
+    template <std::size_t MAX_SIZE = 32, class PartialPredicate>
+    auto find_all_stack(PartialPredicate pred)
+    {
+        assert(static_cast<std::size_t>(k_) <= MAX_SIZE);
+        using boost::container::static_vector;
+        return CombinationTree<IntType,
+                               PartialPredicate,
+                               static_vector<IntType, MAX_SIZE>>(n_, k_, pred);
+    }
+
+    ///////////////////////////////////////////////
+    /// \brief Like find_all(pred), but with a stateful predicate, so that
+    /// checking each partial combination is O(1) instead of O(k). See
+    /// StatefulCombinationTree.
+    ///
+    /// \param init is the state of the empty combination.
+    /// \param push(const State& s, IntType x) should return the state after
+    /// appending x to a partial combination with state s, or boost::none if no
+    /// combination that starts like that should be considered.
+    /////////////////////////////////////////////
+    template <class State, class Push>
+    auto find_all(State init, Push push)
+    {
+        return StatefulCombinationTree<IntType, State, Push, RAContainerInt>(
+          n_, k_, std::move(init), std::move(push));
+    }
+
+    ///////////////////////////////////////////////
+    /// \brief The number of combinations find_all(init, push) would visit,
+    /// computed without visiting them by memoizing on key(state). See
+    /// count_combination_tree for the requirements on key.
+    /////////////////////////////////////////////
+    template <class State, class Push, class Key>
+    size_type count_all(const State& init,
+                        const Push& push,
+                        const Key& key,
+                        size_t num_threads = 1) const
+    {
+        return count_combination_tree(n_, k_, init, push, key, num_threads);
+    }
+
     template <class Func>
     void for_each(Func f) const
     {
@@ -533,6 +624,42 @@ public:
         return false;
     }
 
+    //* Same as next_combination, but calls on_change(from, to) for every
+    // element that changes, from old value to new value. */
+    template <class OnChange>
+    static void next_combination_tracked(combination& data,
+                                         IntType n,
+                                         OnChange on_change)
+    {
+        const IntType k = data.size();
+        if (k == 0)
+            return;
+
+        const IntType last = k - 1;
+        if (data[last] + 1 < n)
+        {
+            on_change(data[last], data[last] + 1);
+            ++data[last];
+            return;
+        }
+
+        const IntType difference = n - k;
+        for (IntType i = k - 2; i >= 0; --i)
+        {
+            if (data[i] != difference + i)
+            {
+                on_change(data[i], data[i] + 1);
+                IntType a = ++data[i] + 1;
+                for (++i; i < k; ++i, ++a)
+                {
+                    on_change(data[i], a);
+                    data[i] = a;
+                }
+                return;
+            }
+        }
+    }
+
     static inline void prev_combination(combination& data, IntType n)
     {
         if (data.empty())
@@ -583,6 +710,31 @@ public:
         return binomial<size_type>(n, k) - result - 1;
     }
 
+    ////////////////////////////////////////////////////////////
+    /// \brief The smallest distance for which iterator::advance constructs
+    /// the combination from scratch instead of stepping to it. Measured the
+    /// first time it's needed for each k (see crossover_table()).
+    ////////////////////////////////////////////////////////////
+    static difference_type crossover_threshold(IntType k)
+    {
+        return crossover_table().get(crossover_family::lex_combinations,
+                                     k,
+                                     [k]() {
+                                         return measure_crossover_threshold(k,
+                                                                            false);
+                                     });
+    }
+
+    static difference_type reverse_crossover_threshold(IntType k)
+    {
+        return crossover_table().get(crossover_family::lex_combinations_reverse,
+                                     k,
+                                     [k]() {
+                                         return measure_crossover_threshold(k,
+                                                                            true);
+                                     });
+    }
+
     ///////////////////////////////////////
     /// \brief Combination comparison "less than" operator. Assumes lhs and rhs
     /// have the same size. \return true if lhs would appear before rhs in the
@@ -612,6 +764,41 @@ private:
     IntType k_;
     size_type size_;
 
+    static difference_type measure_crossover_threshold(IntType k, bool reverse)
+    {
+        if (k < 1)
+            return 1;
+
+        IntType n = CrossoverTable::sample_n(k);
+        size_type total = binomial<size_type>(n, k);
+        combination data(k);
+        std::iota(data.begin(), data.end(), 0);
+
+        auto step = [&]() {
+            if (!reverse)
+            {
+                if (!next_combination(data, n, k, n - k))
+                    std::iota(data.begin(), data.end(), 0);
+                return;
+            }
+
+            if (data.back() == k - 1)
+                std::iota(data.begin(), data.end(), n - k);
+            else
+                prev_combination(data, n);
+        };
+
+        // Knuth's multiplicative hash, to jump around pseudo-randomly
+        auto unrank = [&](int i) {
+            size_type m = (size_type(i)*2654435761LL)%total;
+            if (reverse)
+                m = binomial<size_type>(n, k) - m - 1;
+            construct_combination(data, m, n);
+        };
+
+        return measure_crossover(step, unrank);
+    }
+
     template <class P>
     bool augment(combination& comb, P pred, IntType start = 0)
     {
@@ -680,11 +867,15 @@ auto lex_combinations(IntTypeN n, IntTypeK k)
     return LexCombinations<IntType>(n, k);
 }
 
-template <class Container, class IntType, typename = EnableIfNotIntegral<Container>>
-auto lex_combinations(const Container& X, IntType k)
+// Borrows X if it is an lvalue, takes ownership (without copying) otherwise.
+template <class Container,
+          class IntType,
+          typename = EnableIfNotIntegral<std::decay_t<Container>>>
+auto lex_combinations(Container&& X, IntType k)
 {
     using comb = LexCombinations<IntType>;
-    return indexed_view_container<Container, comb>(X, comb(X.size(), k));
+    comb C(X.size(), k);
+    return indexed_view_container(std::forward<Container>(X), std::move(C));
 }
 
 template <class IntTypeN,
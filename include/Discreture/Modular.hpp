@@ -0,0 +1,458 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "NumberTheory.hpp"
+
+namespace discreture
+{
+
+//////////////////////////////////////////
+/// \brief Arithmetic modulo any m < 2^32 using Barrett reduction: reducing a
+/// 64-bit number costs one 128-bit multiplication instead of a division.
+//////////////////////////////////////////
+class Barrett
+{
+public:
+    explicit Barrett(std::uint32_t m) : m_(m), r_(~std::uint64_t(0)/m) {}
+
+    std::uint32_t modulus() const { return m_; }
+
+    std::uint32_t reduce(std::uint64_t x) const
+    {
+        std::uint64_t q = detail::mulhi64(x, r_);
+        std::uint64_t r = x - q*m_;
+        while (r >= m_)
+            r -= m_;
+        return static_cast<std::uint32_t>(r);
+    }
+
+    std::uint32_t mul(std::uint32_t a, std::uint32_t b) const
+    {
+        return reduce(std::uint64_t(a)*b);
+    }
+
+    std::uint32_t add(std::uint32_t a, std::uint32_t b) const
+    {
+        std::uint64_t s = std::uint64_t(a) + b;
+        return static_cast<std::uint32_t>(s >= m_ ? s - m_ : s);
+    }
+
+    std::uint32_t sub(std::uint32_t a, std::uint32_t b) const
+    {
+        return a >= b ? a - b : a + (m_ - b);
+    }
+
+    std::uint32_t pow(std::uint32_t a, std::uint64_t e) const
+    {
+        std::uint32_t r = reduce(1);
+        while (e > 0)
+        {
+            if (e & 1)
+                r = mul(r, a);
+            a = mul(a, a);
+            e >>= 1;
+        }
+        return r;
+    }
+
+private:
+    std::uint32_t m_;
+    std::uint64_t r_; // floor((2^64-1)/m)
+};
+
+//////////////////////////////////////////
+/// \brief Arithmetic modulo an odd n < 2^31 in Montgomery form: x is stored
+/// as x*2^32 mod n, and multiplying costs three 32-bit multiplications and no
+/// division. Convert with to() and from().
+///
+/// Best for long chains of multiplications (powers, products, polynomial
+/// evaluation), since converting in and out costs a multiplication each.
+//////////////////////////////////////////
+class Montgomery
+{
+public:
+    explicit Montgomery(std::uint32_t n) : n_(n), inv_(n)
+    {
+        assert(n%2 == 1 && n < (1U << 31));
+        for (int i = 0; i < 4; ++i)
+            inv_ *= 2 - n_*inv_;
+        std::uint64_t r = (std::uint64_t(1) << 32)%n_;
+        r2_ = static_cast<std::uint32_t>(r*r%n_);
+    }
+
+    std::uint32_t modulus() const { return n_; }
+
+    std::uint32_t one() const { return to(1); }
+
+    std::uint32_t to(std::uint32_t x) const
+    {
+        return reduce(std::uint64_t(x%n_)*r2_);
+    }
+
+    std::uint32_t from(std::uint32_t x) const { return reduce(x); }
+
+    // t < n*2^32
+    std::uint32_t reduce(std::uint64_t t) const
+    {
+        auto hi = static_cast<std::uint32_t>(t >> 32);
+        std::uint32_t m = static_cast<std::uint32_t>(t)*inv_;
+        auto mn = static_cast<std::uint32_t>((std::uint64_t(m)*n_) >> 32);
+        std::uint32_t r = hi - mn;
+        if (hi < mn)
+            r += n_;
+        return r;
+    }
+
+    std::uint32_t mul(std::uint32_t a, std::uint32_t b) const
+    {
+        return reduce(std::uint64_t(a)*b);
+    }
+
+    std::uint32_t add(std::uint32_t a, std::uint32_t b) const
+    {
+        std::uint32_t s = a + b;
+        return s >= n_ ? s - n_ : s;
+    }
+
+    std::uint32_t sub(std::uint32_t a, std::uint32_t b) const
+    {
+        return a >= b ? a - b : a + (n_ - b);
+    }
+
+    std::uint32_t pow(std::uint32_t a, std::uint64_t e) const
+    {
+        std::uint32_t r = one();
+        while (e > 0)
+        {
+            if (e & 1)
+                r = mul(r, a);
+            a = mul(a, a);
+            e >>= 1;
+        }
+        return r;
+    }
+
+private:
+    std::uint32_t n_;
+    std::uint32_t inv_; // n*inv = 1 mod 2^32
+    std::uint32_t r2_;  // 2^64 mod n
+};
+
+//////////////////////////////////////////
+/// \brief a^e mod m.
+//////////////////////////////////////////
+inline std::uint32_t pow_mod(std::uint64_t a, std::uint64_t e, std::uint32_t m)
+{
+    Barrett B(m);
+    return B.pow(B.reduce(a), e);
+}
+
+//////////////////////////////////////////
+/// \brief The inverse of a modulo m, which must be coprime to a.
+//////////////////////////////////////////
+inline std::uint32_t inverse_mod(std::uint64_t a, std::uint32_t m)
+{
+    std::int64_t r0 = m, r1 = a%m;
+    std::int64_t s0 = 0, s1 = 1;
+    while (r1 != 0)
+    {
+        std::int64_t q = r0/r1;
+        std::tie(r0, r1) = std::make_pair(r1, r0 - q*r1);
+        std::tie(s0, s1) = std::make_pair(s1, s0 - q*s1);
+    }
+    assert(r0 == 1 && "inverse_mod: not invertible");
+    if (s0 < 0)
+        s0 += m;
+    return static_cast<std::uint32_t>(s0%m);
+}
+
+//////////////////////////////////////////
+/// \brief The inverses of 1, ..., n modulo a prime p > n (result[0] = 0),
+/// in linear time.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> inverses_mod(std::uint32_t n, std::uint32_t p)
+{
+    assert(n < p);
+    Barrett B(p);
+    std::vector<std::uint32_t> inv(n + 1, 0);
+    if (n >= 1)
+        inv[1] = 1;
+    // p = (p/i)*i + p%i, so 1/i = -(p/i)/(p%i)
+    for (std::uint32_t i = 2; i <= n; ++i)
+        inv[i] = B.mul(p - p/i, inv[p%i]);
+    return inv;
+}
+
+//////////////////////////////////////////
+/// \brief binomial(n,k) modulo a prime p, in O(1) after O(N) precomputation
+/// of factorials and inverse factorials mod p.
+///
+/// For n <= N (and n < p) it's three table lookups and two multiplications.
+/// If N >= p-1, then any n works by Lucas's theorem, in O(log_p(n)).
+/// Otherwise n > N throws std::out_of_range.
+///
+/// # Example:
+///
+///     BinomialMod C(1000000, 998244353);
+///     auto x = C(123456, 789); // binomial(123456,789) mod 998244353
+//////////////////////////////////////////
+class BinomialMod
+{
+public:
+    BinomialMod(std::uint32_t N, std::uint32_t p)
+        : B_(p), fact_(std::min<std::uint64_t>(N, p - 1) + 1), inv_fact_(fact_.size())
+    {
+        assert(is_prime(p));
+        fact_[0] = B_.reduce(1);
+        for (std::size_t i = 1; i < fact_.size(); ++i)
+            fact_[i] = B_.mul(fact_[i - 1], static_cast<std::uint32_t>(i));
+
+        // one inversion, then multiply back down
+        inv_fact_.back() = B_.pow(fact_.back(), p - 2);
+        for (std::size_t i = fact_.size() - 1; i > 0; --i)
+            inv_fact_[i - 1] = B_.mul(inv_fact_[i], static_cast<std::uint32_t>(i));
+    }
+
+    std::uint32_t modulus() const { return B_.modulus(); }
+
+    std::uint32_t operator()(std::uint64_t n, std::uint64_t k) const
+    {
+        if (k > n)
+            return 0;
+
+        const std::uint64_t p = modulus();
+        if (n < fact_.size())
+            return small(n, k);
+
+        if (fact_.size() != p)
+            throw std::out_of_range("BinomialMod: n is larger than N");
+
+        // Lucas: binomial(n,k) = prod binomial(n_i,k_i) over the base p digits
+        std::uint32_t result = B_.reduce(1);
+        while (n > 0 && result != 0)
+        {
+            result = B_.mul(result, small(n%p, k%p));
+            n /= p;
+            k /= p;
+        }
+        return result;
+    }
+
+    std::uint32_t factorial(std::uint64_t n) const { return fact_[n]; }
+
+    std::uint32_t inverse_factorial(std::uint64_t n) const { return inv_fact_[n]; }
+
+    //////////////////////////////////////////
+    /// \brief 1/n mod p, for 1 <= n <= N.
+    //////////////////////////////////////////
+    std::uint32_t inverse(std::uint64_t n) const
+    {
+        return B_.mul(inv_fact_[n], fact_[n - 1]);
+    }
+
+private:
+    Barrett B_;
+    std::vector<std::uint32_t> fact_;
+    std::vector<std::uint32_t> inv_fact_;
+
+    std::uint32_t small(std::uint64_t n, std::uint64_t k) const
+    {
+        if (k > n)
+            return 0;
+        return B_.mul(fact_[n], B_.mul(inv_fact_[k], inv_fact_[n - k]));
+    }
+};
+
+//////////////////////////////////////////
+/// \brief binomial(n,k) modulo a prime power q = p^e, for any 64-bit n.
+///
+/// Uses Granville's generalization of Lucas's theorem: n! = p^v*(n!)_p, where
+/// (n!)_p, the product of the factors coprime to p, is computed from a table
+/// of size q in O(log_p(n)). Takes O(q) memory, so q should be smallish.
+//////////////////////////////////////////
+class BinomialModPrimePower
+{
+public:
+    BinomialModPrimePower(std::uint32_t p, int e) : p_(p), e_(e), q_(1), B_(1)
+    {
+        assert(is_prime(p) && e >= 1);
+        for (int i = 0; i < e; ++i)
+            q_ *= p;
+        B_ = Barrett(q_);
+
+        F_.resize(q_ + 1);
+        F_[0] = B_.reduce(1);
+        for (std::uint32_t i = 1; i <= q_; ++i)
+            F_[i] = (i%p_ == 0) ? F_[i - 1] : B_.mul(F_[i - 1], i);
+    }
+
+    std::uint32_t modulus() const { return q_; }
+
+    std::uint32_t operator()(std::uint64_t n, std::uint64_t k) const
+    {
+        if (k > n)
+            return 0;
+
+        std::uint64_t v = legendre(n) - legendre(k) - legendre(n - k);
+        if (v >= static_cast<std::uint64_t>(e_))
+            return 0;
+
+        std::uint32_t result = B_.pow(p_%q_, v);
+        result = B_.mul(result, coprime_factorial(n));
+        std::uint32_t denominator = B_.mul(coprime_factorial(k), coprime_factorial(n - k));
+        return B_.mul(result, inverse_mod(denominator, q_));
+    }
+
+private:
+    std::uint32_t p_;
+    int e_;
+    std::uint32_t q_;
+    Barrett B_;
+    std::vector<std::uint32_t> F_; // F_[i] = product of j <= i coprime to p, mod q
+
+    // exponent of p in n!
+    std::uint64_t legendre(std::uint64_t n) const
+    {
+        std::uint64_t v = 0;
+        while (n > 0)
+        {
+            n /= p_;
+            v += n;
+        }
+        return v;
+    }
+
+    // n! with all factors of p removed, mod q
+    std::uint32_t coprime_factorial(std::uint64_t n) const
+    {
+        std::uint32_t result = B_.reduce(1);
+        while (n > 1)
+        {
+            result = B_.mul(result, B_.pow(F_[q_], n/q_));
+            result = B_.mul(result, F_[n%q_]);
+            n /= p_;
+        }
+        return result;
+    }
+};
+
+//////////////////////////////////////////
+/// \brief binomial(n,k) mod m for any 1 <= m < 2^32.
+///
+/// Factors m, computes the binomial modulo each prime power with
+/// BinomialModPrimePower and combines them with the chinese remainder
+/// theorem. Takes time and memory proportional to the largest prime power
+/// dividing m, so for many binomials modulo the same prime use BinomialMod.
+//////////////////////////////////////////
+inline std::uint32_t binomial_mod(std::uint64_t n, std::uint64_t k, std::uint32_t m)
+{
+    if (m == 1)
+        return 0;
+
+    std::uint64_t result = 0;
+    std::uint64_t modulus = 1;
+    for (auto pa : factorize(m))
+    {
+        BinomialModPrimePower C(static_cast<std::uint32_t>(pa.p), pa.a);
+        std::uint32_t q = C.modulus();
+        std::uint32_t r = C(n, k);
+
+        // result = r mod q and result = result mod modulus
+        auto t = static_cast<std::uint32_t>(
+          (std::uint64_t(r + q - result%q)%q)*inverse_mod(modulus%q, q)%q);
+        result += modulus*t;
+        modulus *= q;
+    }
+    return static_cast<std::uint32_t>(result);
+}
+
+//////////////////////////////////////////
+/// \brief catalan(0), ..., catalan(N) mod a prime p > N+1.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> catalan_mod_table(std::uint32_t N, std::uint32_t p)
+{
+    assert(N + 1 < p);
+    Barrett B(p);
+    auto inv = inverses_mod(N + 1, p);
+    std::vector<std::uint32_t> C(N + 1);
+    C[0] = B.reduce(1);
+    // C_n = C_{n-1}*2(2n-1)/(n+1)
+    for (std::uint32_t n = 1; n <= N; ++n)
+        C[n] = B.mul(B.mul(C[n - 1], B.reduce(2*(2*std::uint64_t(n) - 1))), inv[n + 1]);
+    return C;
+}
+
+//////////////////////////////////////////
+/// \brief motzkin(0), ..., motzkin(N) mod a prime p > N+2.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> motzkin_mod_table(std::uint32_t N, std::uint32_t p)
+{
+    assert(N + 2 < p);
+    Barrett B(p);
+    auto inv = inverses_mod(N + 2, p);
+    std::vector<std::uint32_t> M(N + 1);
+    M[0] = B.reduce(1);
+    if (N >= 1)
+        M[1] = B.reduce(1);
+    // (n+2)M_n = (2n+1)M_{n-1} + 3(n-1)M_{n-2}
+    for (std::uint32_t n = 2; n <= N; ++n)
+    {
+        auto a = B.mul(B.reduce(2*std::uint64_t(n) + 1), M[n - 1]);
+        auto b = B.mul(B.reduce(3*std::uint64_t(n - 1)), M[n - 2]);
+        M[n] = B.mul(B.add(a, b), inv[n + 2]);
+    }
+    return M;
+}
+
+//////////////////////////////////////////
+/// \brief Rows 0..N of Stirling numbers of the second kind mod any m, so
+/// that result[n][k] = stirling_partition_number(n,k) mod m.
+//////////////////////////////////////////
+inline std::vector<std::vector<std::uint32_t>>
+stirling_partition_mod_table(std::uint32_t N, std::uint32_t m)
+{
+    Barrett B(m);
+    std::vector<std::vector<std::uint32_t>> S(N + 1);
+    S[0] = {B.reduce(1)};
+    for (std::uint32_t n = 1; n <= N; ++n)
+    {
+        S[n].assign(n + 1, 0);
+        for (std::uint32_t k = 1; k <= n; ++k)
+        {
+            std::uint32_t left = k < n ? B.mul(B.reduce(k), S[n - 1][k]) : 0;
+            S[n][k] = B.add(left, S[n - 1][k - 1]);
+        }
+    }
+    return S;
+}
+
+//////////////////////////////////////////
+/// \brief Rows 0..N of (unsigned) Stirling numbers of the first kind mod any
+/// m, so that result[n][k] = stirling_cycle_number(n,k) mod m.
+//////////////////////////////////////////
+inline std::vector<std::vector<std::uint32_t>>
+stirling_cycle_mod_table(std::uint32_t N, std::uint32_t m)
+{
+    Barrett B(m);
+    std::vector<std::vector<std::uint32_t>> S(N + 1);
+    S[0] = {B.reduce(1)};
+    for (std::uint32_t n = 1; n <= N; ++n)
+    {
+        S[n].assign(n + 1, 0);
+        for (std::uint32_t k = 1; k <= n; ++k)
+        {
+            std::uint32_t left = k < n ? B.mul(B.reduce(n - 1), S[n - 1][k]) : 0;
+            S[n][k] = B.add(left, S[n - 1][k - 1]);
+        }
+    }
+    return S;
+}
+
+} // namespace discreture
@@ -102,6 +102,38 @@ public:
 
     IntType get_n() const { return n_; }
 
+    ////////////////////////////////////////////////////////////
+    /// \brief A uniformly random motzkin path.
+    ///
+    /// A motzkin path with 2k non-flat steps is a choice of their positions
+    /// and a dyck path of size k, so k is chosen with probability
+    /// binomial(n,2k)catalan(k)/M_n and then both parts are chosen uniformly.
+    ///
+    /// \param engine is any uniform random bit generator.
+    ////////////////////////////////////////////////////////////
+    template <class Engine>
+    motzkin_path random(Engine& engine) const
+    {
+        std::vector<double> weights;
+        for (IntType k = 0; 2*k <= n_; ++k)
+            weights.push_back(binomial<double>(n_, 2*k)*catalan<double>(k));
+
+        std::discrete_distribution<IntType> choose_k(weights.begin(),
+                                                     weights.end());
+        IntType k = choose_k(engine);
+
+        auto positions = Combinations<IntType, RAContainerInt>(n_, 2*k).random(engine);
+        auto dyck = DyckPaths<IntType, RAContainerInt>(k).random(engine);
+
+        motzkin_path result(n_, 0);
+        for (IntType i = 0; i < 2*k; ++i)
+            result[positions[i]] = dyck[i];
+
+        return result;
+    }
+
+    motzkin_path random() const { return random(random::random_engine()); }
+
     iterator begin() const { return iterator(n_); }
 
     iterator end() const { return iterator::make_invalid_with_id(size()); }
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "NumberTheory.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DISCRETURE_HAS_MMAP
+#endif
+
+namespace discreture
+{
+
+//////////////////////////////////////////
+/// \brief Fills out[0,hi-lo) with f(lo), ..., f(hi-1) for a multiplicative
+/// function f, sieving [lo,hi) in cache-sized blocks.
+///
+/// \param update(T& v, p, k, pk) is called for every prime power p^k = pk
+/// dividing m (in increasing order of k), and must turn v = f(m')f(p^(k-1))
+/// into v = f(m')f(p^k). v starts at T(1). For example, for Euler's phi:
+///
+///     [](auto& v, auto p, int k, auto) { v *= (k == 1 ? p - 1 : p); }
+///
+/// Other than one division per number for the prime factor larger than
+/// sqrt(hi) (if there is one), the sieve itself does no divisions.
+/// out[i] is set to 0 if lo+i is 0.
+///
+/// \param num_threads splits the range in that many parts, sieved in
+/// parallel.
+//////////////////////////////////////////
+template <class T, class Update>
+void fill_multiplicative(std::uint64_t lo,
+                         std::uint64_t hi,
+                         T* out,
+                         Update update,
+                         std::size_t num_threads = 1)
+{
+    if (hi <= lo)
+        return;
+
+    auto base = detail::base_odd_primes(isqrt(hi - 1));
+    base.insert(base.begin(), 2);
+
+    detail::for_each_chunk(lo, hi, num_threads, [&](std::uint64_t a, std::uint64_t b, std::size_t) {
+        if (a >= b)
+            return;
+
+        const std::uint64_t block = detail::sieve_segment_bytes;
+        // prod[i] is the part of a+i factored so far
+        std::vector<std::uint64_t> prod(block);
+
+        // next multiples of p and p^2, carried over from block to block
+        std::vector<std::uint64_t> next1(base.size());
+        std::vector<std::uint64_t> next2(base.size());
+        for (std::size_t i = 0; i < base.size(); ++i)
+        {
+            std::uint64_t p = base[i];
+            next1[i] = (a + p - 1)/p*p;
+            next2[i] = (a + p*p - 1)/(p*p)*(p*p);
+        }
+
+        for (std::uint64_t first = a; first < b; first += block)
+        {
+            std::uint64_t last = std::min(b, first + block);
+            T* v = out + (first - lo);
+            std::fill(v, v + (last - first), T(1));
+            std::fill(prod.begin(), prod.begin() + (last - first), 1);
+
+            for (std::size_t i = 0; i < base.size(); ++i)
+            {
+                const std::uint64_t p = base[i];
+                std::uint64_t m = next1[i];
+                for (; m < last; m += p)
+                {
+                    update(v[m - first], p, 1, p);
+                    prod[m - first] *= p;
+                }
+                next1[i] = m;
+
+                const std::uint64_t p2 = p*p;
+                m = next2[i];
+                if (m >= last)
+                    continue;
+                for (; m < last; m += p2)
+                {
+                    update(v[m - first], p, 2, p2);
+                    prod[m - first] *= p;
+                }
+                next2[i] = m;
+
+                // Higher powers are rare enough to compute their starts.
+                std::uint64_t pk = p2;
+                for (int k = 3; pk <= (last - 1)/p; ++k)
+                {
+                    pk *= p;
+                    for (m = (first + pk - 1)/pk*pk; m < last; m += pk)
+                    {
+                        update(v[m - first], p, k, pk);
+                        prod[m - first] *= p;
+                    }
+                }
+            }
+
+            for (std::uint64_t m = first; m < last; ++m)
+            {
+                std::uint64_t q = prod[m - first];
+                if (m != 0 && q != m)
+                {
+                    q = m/q;
+                    update(v[m - first], q, 1, q);
+                }
+            }
+
+            if (first == 0)
+                v[0] = T(0);
+        }
+    });
+}
+
+//////////////////////////////////////////
+/// \brief Möbius function mu(m) for m in [lo,hi) into out.
+//////////////////////////////////////////
+template <class T>
+void fill_mobius(std::uint64_t lo, std::uint64_t hi, T* out, std::size_t num_threads = 1)
+{
+    fill_multiplicative(lo,
+                        hi,
+                        out,
+                        [](T& v, std::uint64_t, int k, std::uint64_t) {
+                            v = (k == 1) ? T(-v) : T(0);
+                        },
+                        num_threads);
+}
+
+//////////////////////////////////////////
+/// \brief Euler's totient function phi(m) for m in [lo,hi) into out.
+//////////////////////////////////////////
+template <class T>
+void fill_totient(std::uint64_t lo, std::uint64_t hi, T* out, std::size_t num_threads = 1)
+{
+    fill_multiplicative(lo,
+                        hi,
+                        out,
+                        [](T& v, std::uint64_t p, int k, std::uint64_t) {
+                            v *= static_cast<T>(k == 1 ? p - 1 : p);
+                        },
+                        num_threads);
+}
+
+//////////////////////////////////////////
+/// \brief Number of divisors d(m) for m in [lo,hi) into out.
+//////////////////////////////////////////
+template <class T>
+void fill_divisor_count(std::uint64_t lo, std::uint64_t hi, T* out, std::size_t num_threads = 1)
+{
+    fill_multiplicative(lo,
+                        hi,
+                        out,
+                        [](T& v, std::uint64_t, int k, std::uint64_t) {
+                            v = v/k*(k + 1);
+                        },
+                        num_threads);
+}
+
+//////////////////////////////////////////
+/// \brief Sum of divisors sigma(m) for m in [lo,hi) into out.
+//////////////////////////////////////////
+template <class T>
+void fill_divisor_sum(std::uint64_t lo, std::uint64_t hi, T* out, std::size_t num_threads = 1)
+{
+    fill_multiplicative(lo,
+                        hi,
+                        out,
+                        [](T& v, std::uint64_t p, int k, std::uint64_t pk) {
+                            if (k == 1)
+                            {
+                                v *= static_cast<T>(p + 1);
+                                return;
+                            }
+                            // sigma(p^(k-1)) = 1 + p + ... + p^(k-1)
+                            auto before = static_cast<T>((pk - 1)/(p - 1));
+                            v = v/before*(before + static_cast<T>(pk));
+                        },
+                        num_threads);
+}
+
+//////////////////////////////////////////
+/// \brief mu(0), ..., mu(n), one byte each.
+//////////////////////////////////////////
+inline std::vector<std::int8_t> mobius_table(std::uint64_t n, std::size_t num_threads = 1)
+{
+    std::vector<std::int8_t> result(n + 1);
+    fill_mobius(0, n + 1, result.data(), num_threads);
+    return result;
+}
+
+//////////////////////////////////////////
+/// \brief phi(0), ..., phi(n), for n < 2^32.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> totient_table(std::uint64_t n, std::size_t num_threads = 1)
+{
+    assert(n <= 0xFFFFFFFFULL);
+    std::vector<std::uint32_t> result(n + 1);
+    fill_totient(0, n + 1, result.data(), num_threads);
+    return result;
+}
+
+//////////////////////////////////////////
+/// \brief d(0), ..., d(n), for n < 2^32 (where d(m) <= 1536).
+//////////////////////////////////////////
+inline std::vector<std::uint16_t> divisor_count_table(std::uint64_t n, std::size_t num_threads = 1)
+{
+    assert(n <= 0xFFFFFFFFULL);
+    std::vector<std::uint16_t> result(n + 1);
+    fill_divisor_count(0, n + 1, result.data(), num_threads);
+    return result;
+}
+
+//////////////////////////////////////////
+/// \brief sigma(0), ..., sigma(n).
+//////////////////////////////////////////
+inline std::vector<std::uint64_t> divisor_sum_table(std::uint64_t n, std::size_t num_threads = 1)
+{
+    std::vector<std::uint64_t> result(n + 1);
+    fill_divisor_sum(0, n + 1, result.data(), num_threads);
+    return result;
+}
+
+#ifdef DISCRETURE_HAS_MMAP
+//////////////////////////////////////////
+/// \brief Fixed size array of trivially copyable T in memory obtained with
+/// mmap: anonymous, or backed by a file.
+///
+/// Meant for tables that are too large to comfortably keep in RAM (or that
+/// should survive the process), filled with the fill_* functions:
+///
+///     mapped_array<std::int8_t> mu("mobius.bin", N + 1);
+///     fill_mobius(0, N + 1, mu.data(), 8);
+///
+/// Pages are only loaded when touched, and the operating system can evict
+/// the pages of a file-backed array instead of swapping.
+//////////////////////////////////////////
+template <class T>
+class mapped_array
+{
+public:
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mapped_array needs trivially copyable elements");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    //////////////////////////////////////////
+    /// \brief Anonymous (zero-initialized) memory for n elements.
+    //////////////////////////////////////////
+    explicit mapped_array(size_type n) : size_(n)
+    {
+        if (n > 0 && !map(-1, MAP_PRIVATE | MAP_ANONYMOUS))
+            throw std::runtime_error("mapped_array: mmap failed");
+    }
+
+    //////////////////////////////////////////
+    /// \brief n elements backed by the file at path. The file keeps its
+    /// contents, and is extended with zeros if it's smaller than that.
+    //////////////////////////////////////////
+    mapped_array(const std::string& path, size_type n) : size_(n)
+    {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+            throw std::runtime_error("mapped_array: cannot open " + path);
+
+        // only grow the file, so a larger one keeps all of its contents
+        struct stat st;
+        bool ok = ::fstat(fd, &st) == 0;
+        if (ok && st.st_size < static_cast<off_t>(bytes()))
+            ok = ::ftruncate(fd, static_cast<off_t>(bytes())) == 0;
+        if (!ok)
+        {
+            ::close(fd);
+            throw std::runtime_error("mapped_array: cannot resize " + path);
+        }
+
+        bool mapped = n == 0 || map(fd, MAP_SHARED);
+        ::close(fd); // the mapping keeps the file open
+        if (!mapped)
+            throw std::runtime_error("mapped_array: cannot map " + path);
+    }
+
+    mapped_array(const mapped_array&) = delete;
+    mapped_array& operator=(const mapped_array&) = delete;
+
+    mapped_array(mapped_array&& other) noexcept
+        : data_(other.data_), size_(other.size_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    mapped_array& operator=(mapped_array&& other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ~mapped_array()
+    {
+        if (data_ != nullptr)
+            ::munmap(data_, bytes());
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    size_type size() const { return size_; }
+
+    T& operator[](size_type i) { return data_[i]; }
+    const T& operator[](size_type i) const { return data_[i]; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+private:
+    T* data_{nullptr};
+    size_type size_;
+
+    size_type bytes() const { return size_*sizeof(T); }
+
+    bool map(int fd, int flags)
+    {
+        void* p = ::mmap(nullptr, bytes(), PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (p == MAP_FAILED)
+            return false;
+        data_ = static_cast<T*>(p);
+        return true;
+    }
+};
+#endif
+
+} // namespace discreture
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "Sequences.hpp"
+#include <boost/iterator/iterator_facade.hpp>
+#include <vector>
+
+namespace discreture
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Partitions of n stored as (part, multiplicity) pairs, in reverse
+/// lexicographic order.
+///
+/// Each successor changes at most three pairs, so iterating is O(1) per
+/// partition, with no scans over the parts (this is ZS1 of Zoghbi and
+/// Stojmenović, in multiplicity form). Use for_each_parts to get the usual
+/// list of parts instead, which is still O(1) amortized.
+///
+/// # Example:
+///
+///     multiplicity_partitions X(5);
+///     for (auto&& x : X)
+///     {
+///         for (auto&& b : x)
+///             cout << b.part << '^' << b.multiplicity << ' ';
+///         cout << "| ";
+///     }
+///
+/// Prints out:
+///
+///     5^1 | 4^1 1^1 | 3^1 2^1 | 3^1 1^2 | 2^2 1^1 | 2^1 1^3 | 1^5 |
+///
+/// which are [5] [4 1] [3 2] [3 1 1] [2 2 1] [2 1 1 1] [1 1 1 1 1].
+////////////////////////////////////////////////////////////
+template <class IntType = int>
+class MultiplicityPartitions
+{
+public:
+    static_assert(std::is_integral<IntType>::value,
+                  "Template parameter IntType must be integral");
+
+    ////////////////////////////////////////////////////////////
+    /// \brief multiplicity copies of part.
+    ////////////////////////////////////////////////////////////
+    struct block
+    {
+        IntType part;
+        IntType multiplicity;
+
+        bool operator==(const block& other) const
+        {
+            return part == other.part && multiplicity == other.multiplicity;
+        }
+
+        bool operator!=(const block& other) const { return !(*this == other); }
+    };
+
+    using value_type = std::vector<block>; // by decreasing part
+    using multiplicity_partition = value_type;
+    using partition = std::vector<IntType>; // parts in decreasing order
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+    class iterator;
+    using const_iterator = iterator;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param n is an integer >= 0
+    ////////////////////////////////////////////////////////////
+    explicit MultiplicityPartitions(IntType n)
+        : n_(n), size_(partition_number(n))
+    {}
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The total number of partitions
+    ///
+    /// \return p_n
+    ////////////////////////////////////////////////////////////
+    size_type size() const { return size_; }
+
+    IntType get_n() const { return n_; }
+
+    iterator begin() const { return iterator(n_); }
+
+    const iterator end() const { return iterator::make_invalid_with_id(size()); }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Calls f(x) for every partition x, in multiplicity form. Faster
+    /// than iterating.
+    ////////////////////////////////////////////////////////////
+    template <class Func>
+    void for_each(Func f) const
+    {
+        multiplicity_partition data;
+        first(data, n_);
+        for (size_type i = 0; i < size_; ++i)
+        {
+            f(static_cast<const multiplicity_partition&>(data));
+            next_partition(data);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Calls f(x) for every partition x, as a list of parts in
+    /// decreasing order (in the same order as for_each).
+    ////////////////////////////////////////////////////////////
+    template <class Func>
+    void for_each_parts(Func f) const
+    {
+        multiplicity_partition data;
+        first(data, n_);
+        partition x = to_parts(data);
+        for (size_type i = 0; i < size_; ++i)
+        {
+            f(static_cast<const partition&>(x));
+
+            // next_partition replaces the ones and one copy of the part v
+            // before them by the blocks at the end of data
+            auto k = data.size();
+            IntType ones = (k > 0 && data[k - 1].part == 1) ? data[k - 1].multiplicity : 0;
+            if (k == std::size_t(ones > 0))
+                break;
+            IntType v = data[k - 1 - (ones > 0)].part;
+            next_partition(data);
+
+            if (v == 2) // [... 2 1^ones] -> [... 1 1^(ones+1)]
+            {
+                x[x.size() - ones - 1] = 1;
+                x.push_back(1);
+                continue;
+            }
+
+            x.resize(x.size() - ones - 1);
+            const auto& last = data.back();
+            if (last.part == v - 1)
+            {
+                x.insert(x.end(), last.multiplicity, v - 1);
+            }
+            else
+            {
+                x.insert(x.end(), data[data.size() - 2].multiplicity, v - 1);
+                x.push_back(last.part);
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forward iterator class.
+    ////////////////////////////////////////////////////////////
+    class iterator
+        : public boost::iterator_facade<iterator,
+                                        const multiplicity_partition&,
+                                        boost::forward_traversal_tag>
+    {
+    public:
+        iterator() = default;
+
+        explicit iterator(IntType n) { first(data_, n); }
+
+        inline size_type ID() const { return ID_; }
+
+        ////////////////////////////////////////////////////////////
+        /// \brief The current partition as a list of parts. O(number of
+        /// parts).
+        ////////////////////////////////////////////////////////////
+        partition parts() const { return to_parts(data_); }
+
+        static const iterator make_invalid_with_id(size_type id)
+        {
+            iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            next_partition(data_);
+        }
+
+        const multiplicity_partition& dereference() const { return data_; }
+
+        bool equal(const iterator& it) const { return it.ID() == ID(); }
+
+    private:
+        size_type ID_{0};
+        multiplicity_partition data_;
+
+        friend class boost::iterator_core_access;
+    }; // end class iterator
+
+    // **************** Begin static functions
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The next partition in reverse lexicographic order. [1 1 ... 1]
+    /// is the last one, and its successor is empty.
+    ////////////////////////////////////////////////////////////
+    static void next_partition(multiplicity_partition& data)
+    {
+        auto k = data.size();
+        IntType ones = 0;
+        if (k > 0 && data[k - 1].part == 1)
+        {
+            ones = data[k - 1].multiplicity;
+            --k;
+        }
+        if (k == 0)
+        {
+            data.clear();
+            return;
+        }
+
+        // Take one copy of the smallest part v > 1, and write it plus the
+        // ones as parts of size v-1 (and a remainder).
+        auto& b = data[k - 1];
+        IntType v = b.part;
+        if (--b.multiplicity == 0)
+            --k;
+
+        if (v == 2) // the most common case, without divisions
+        {
+            data.resize(k + 1);
+            data[k] = {1, IntType(ones + 2)};
+            return;
+        }
+
+        IntType total = v + ones;
+        IntType q = total/(v - 1);
+        IntType r = total - q*(v - 1);
+        data.resize(k + 1 + (r > 0));
+        data[k] = {IntType(v - 1), q};
+        if (r > 0)
+            data[k + 1] = {r, 1};
+    }
+
+    static partition to_parts(const multiplicity_partition& data)
+    {
+        partition result;
+        for (auto& b : data)
+            result.insert(result.end(), b.multiplicity, b.part);
+        return result;
+    }
+
+    static multiplicity_partition to_multiplicities(const partition& P)
+    {
+        multiplicity_partition result;
+        for (auto x : P)
+        {
+            if (!result.empty() && result.back().part == x)
+                ++result.back().multiplicity;
+            else
+                result.push_back({x, 1});
+        }
+        return result;
+    }
+
+    // **************** End static functions
+
+private:
+    IntType n_;
+    size_type size_;
+
+    static void first(multiplicity_partition& data, IntType n)
+    {
+        data.clear();
+        if (n > 0)
+            data.push_back({n, 1});
+    }
+
+}; // end class MultiplicityPartitions
+
+using multiplicity_partitions = MultiplicityPartitions<int>;
+
+} // namespace discreture
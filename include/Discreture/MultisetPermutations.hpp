@@ -0,0 +1,471 @@
+#pragma once
+
+#include "IndexedViewContainer.hpp"
+#include "Probability.hpp"
+#include "Sequences.hpp"
+#include "TemplateHelpers.hpp"
+#include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
+#include <vector>
+
+namespace discreture
+{
+
+////////////////////////////////////////////////////////////
+/// \brief The distinct permutations of a multiset, in lexicographic order.
+///
+/// The multiset is given by its counts: counts[i] copies of i. So each
+/// element is a sequence of length counts[0]+counts[1]+... in which i appears
+/// exactly counts[i] times. Every distinct arrangement is generated exactly
+/// once, so there are (c_0+c_1+...)!/(c_0! c_1! ...) of them (a multinomial)
+/// and not n!.
+///
+/// The successor is std::next_permutation, which is O(1) amortized on
+/// multisets too, and rank/unrank walk the positions keeping the multinomial
+/// of what is left.
+///
+/// # Example:
+///
+///     MultisetPermutations<int> X({2, 1});
+///     for (auto&& x : X)
+///         cout << x << ' ';
+///
+/// Prints out:
+///
+///     [ 0 0 1 ] [ 0 1 0 ] [ 1 0 0 ]
+///
+/// For a container of objects, use multiset_permutations(A) (see below).
+////////////////////////////////////////////////////////////
+template <class IntType = int, class RAContainerInt = std::vector<IntType>>
+class MultisetPermutations
+{
+public:
+    static_assert(std::is_integral<IntType>::value,
+                  "Template parameter IntType must be integral");
+    static_assert(std::is_signed<IntType>::value,
+                  "Template parameter IntType must be signed");
+    using value_type = RAContainerInt;
+    using permutation = value_type;
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+    class iterator;
+    using const_iterator = iterator;
+    class reverse_iterator;
+    using const_reverse_iterator = reverse_iterator;
+
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param counts[i] >= 0 is the number of copies of i.
+    ////////////////////////////////////////////////////////////
+    explicit MultisetPermutations(std::vector<IntType> counts)
+        : counts_(std::move(counts)), size_(multinomial(counts_))
+    {
+        for (auto c : counts_)
+            n_ += c;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The number of distinct permutations
+    ///
+    /// \return (c_0+c_1+...)!/(c_0! c_1! ...)
+    ////////////////////////////////////////////////////////////
+    size_type size() const { return size_; }
+
+    const std::vector<IntType>& counts() const { return counts_; }
+
+    iterator begin() const { return iterator(first()); }
+
+    const iterator end() const { return iterator(first(), size()); }
+
+    reverse_iterator rbegin() const { return reverse_iterator(last()); }
+
+    const reverse_iterator rend() const
+    {
+        return reverse_iterator(last(), size());
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Access to the m-th permutation (slow for iteration)
+    ///
+    /// \param m should be an integer between 0 and size().
+    ////////////////////////////////////////////////////////////
+    permutation operator[](size_type m) const
+    {
+        assert(0 <= m && m < size());
+        permutation x(n_);
+        construct_permutation(x, counts_, m);
+        return x;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Inverse of operator[]: the index of x in lexicographic order.
+    ////////////////////////////////////////////////////////////
+    size_type get_index(const permutation& x) const { return get_index(x, counts_); }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief A uniformly random distinct permutation. (Every arrangement
+    /// comes from the same number of shuffles.)
+    ////////////////////////////////////////////////////////////
+    template <class Engine>
+    permutation random(Engine& engine) const
+    {
+        permutation x = first();
+        std::shuffle(x.begin(), x.end(), engine);
+        return x;
+    }
+
+    permutation random() const { return random(random::random_engine()); }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Calls f(x) for every permutation x, in order. Faster than
+    /// iterating.
+    ////////////////////////////////////////////////////////////
+    template <class Func>
+    void for_each(Func f) const
+    {
+        permutation x = first();
+        do
+        {
+            f(static_cast<const permutation&>(x));
+        } while (std::next_permutation(x.begin(), x.end()));
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Random access iterator class. It's much more efficient as a
+    /// bidirectional iterator than purely random access.
+    ////////////////////////////////////////////////////////////
+    class iterator
+        : public boost::iterator_facade<iterator, const permutation&, boost::random_access_traversal_tag>
+    {
+    public:
+        iterator() = default;
+
+        explicit iterator(permutation first) : data_(std::move(first))
+        {
+            size_ = multinomial(counts_of(data_));
+        }
+
+        // The id-th permutation of the elements of x, or end() if id is the
+        // number of them.
+        iterator(permutation x, size_type id) : ID_(id), data_(std::move(x))
+        {
+            auto counts = counts_of(data_);
+            size_ = multinomial(counts);
+            place(std::move(counts));
+        }
+
+        inline size_type ID() const { return ID_; }
+
+        static const iterator make_invalid_with_id(size_type id)
+        {
+            iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            std::next_permutation(data_.begin(), data_.end());
+        }
+
+        void decrement()
+        {
+            --ID_;
+            std::prev_permutation(data_.begin(), data_.end());
+        }
+
+        const permutation& dereference() const { return data_; }
+
+        void advance(difference_type m)
+        {
+            assert(0 <= m + ID_);
+            if (std::abs(m) < difference_type(data_.size()))
+            {
+                for (; m > 0; --m)
+                    increment();
+                for (; m < 0; ++m)
+                    decrement();
+                return;
+            }
+
+            ID_ += m;
+            place(counts_of(data_));
+        }
+
+        // Makes data_ the ID_-th permutation. At end(), it's the first one,
+        // like after stepping past the last one with next_permutation, so
+        // that decrementing gives the last one.
+        void place(std::vector<IntType> counts)
+        {
+            if (ID_ < size_)
+                construct_permutation(data_, std::move(counts), ID_);
+            else if (ID_ == size_)
+                std::sort(data_.begin(), data_.end());
+        }
+
+        difference_type distance_to(const iterator& other) const
+        {
+            return static_cast<difference_type>(other.ID()) - ID();
+        }
+
+        bool equal(const iterator& other) const { return ID_ == other.ID_; }
+
+    private:
+        size_type ID_{0};
+        size_type size_{1};
+        permutation data_{};
+
+        friend class boost::iterator_core_access;
+    }; // end class iterator
+
+    class reverse_iterator
+        : public boost::iterator_facade<reverse_iterator,
+                                        const permutation&,
+                                        boost::random_access_traversal_tag>
+    {
+    public:
+        reverse_iterator() = default;
+
+        explicit reverse_iterator(permutation last) : data_(std::move(last))
+        {
+            if (!data_.empty())
+                size_ = multinomial(counts_of(data_));
+        }
+
+        // The id-th permutation of the elements of x from the end, or rend()
+        // if id is the number of them.
+        reverse_iterator(permutation x, size_type id) : ID_(id), data_(std::move(x))
+        {
+            auto counts = counts_of(data_);
+            size_ = multinomial(counts);
+            place(std::move(counts));
+        }
+
+        inline size_type ID() const { return ID_; }
+
+        static const reverse_iterator make_invalid_with_id(size_type id)
+        {
+            reverse_iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+            std::prev_permutation(data_.begin(), data_.end());
+        }
+
+        void decrement()
+        {
+            --ID_;
+            std::next_permutation(data_.begin(), data_.end());
+        }
+
+        const permutation& dereference() const { return data_; }
+
+        void advance(difference_type m)
+        {
+            assert(0 <= m + ID_);
+            if (std::abs(m) < difference_type(data_.size()))
+            {
+                for (; m > 0; --m)
+                    increment();
+                for (; m < 0; ++m)
+                    decrement();
+                return;
+            }
+
+            ID_ += m;
+            place(counts_of(data_));
+        }
+
+        // Makes data_ the ID_-th permutation from the end. At rend(), it's
+        // the last one, like after stepping past the first one with
+        // prev_permutation, so that decrementing gives the first one.
+        void place(std::vector<IntType> counts)
+        {
+            if (ID_ < size_)
+                construct_permutation(data_, std::move(counts), size_ - ID_ - 1);
+            else if (ID_ == size_)
+                std::sort(data_.rbegin(), data_.rend());
+        }
+
+        difference_type distance_to(const reverse_iterator& other) const
+        {
+            return static_cast<difference_type>(other.ID()) - ID();
+        }
+
+        bool equal(const reverse_iterator& other) const { return ID_ == other.ID_; }
+
+    private:
+        size_type ID_{0};
+        size_type size_{1};
+        permutation data_{};
+
+        friend class boost::iterator_core_access;
+    }; // end class reverse_iterator
+
+    // **************** Begin static functions
+
+    ////////////////////////////////////////////////////////////
+    /// \brief (c_0+c_1+...)!/(c_0! c_1! ...), as a product of binomials.
+    ////////////////////////////////////////////////////////////
+    static size_type multinomial(const std::vector<IntType>& counts)
+    {
+        size_type result = 1;
+        IntType total = 0;
+        for (auto c : counts)
+        {
+            total += c;
+            result *= binomial<size_type>(total, c);
+        }
+        return result;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Makes x the m-th permutation of the multiset with the given
+    /// counts. x must already have the right size.
+    ////////////////////////////////////////////////////////////
+    static void construct_permutation(permutation& x, std::vector<IntType> counts, size_type m)
+    {
+        size_type M = multinomial(counts); // arrangements of what is left
+        IntType r = x.size();
+        for (IntType i = 0; i < IntType(x.size()); ++i, --r)
+        {
+            for (IntType v = 0;; ++v)
+            {
+                if (counts[v] == 0)
+                    continue;
+                // how many of them start with v
+                size_type block = starting_with(M, counts[v], r);
+                if (m < block)
+                {
+                    x[i] = v;
+                    --counts[v];
+                    M = block;
+                    break;
+                }
+                m -= block;
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The index of x among the permutations of the multiset with the
+    /// given counts, in lexicographic order.
+    ////////////////////////////////////////////////////////////
+    static size_type get_index(const permutation& x, std::vector<IntType> counts)
+    {
+        size_type M = multinomial(counts);
+        size_type result = 0;
+        IntType r = x.size();
+        for (IntType i = 0; i < IntType(x.size()); ++i, --r)
+        {
+            for (IntType v = 0; v < x[i]; ++v)
+            {
+                if (counts[v] > 0)
+                    result += starting_with(M, counts[v], r);
+            }
+            M = starting_with(M, counts[x[i]], r);
+            --counts[x[i]];
+        }
+        return result;
+    }
+
+    // **************** End static functions
+
+private:
+    std::vector<IntType> counts_;
+    size_type size_;
+    IntType n_{0};
+
+    permutation first() const
+    {
+        permutation x(n_);
+        auto it = x.begin();
+        for (IntType i = 0; i < IntType(counts_.size()); ++i)
+            it = std::fill_n(it, counts_[i], i);
+        return x;
+    }
+
+    permutation last() const
+    {
+        permutation x = first();
+        std::reverse(x.begin(), x.end());
+        return x;
+    }
+
+    static std::vector<IntType> counts_of(const permutation& x)
+    {
+        std::vector<IntType> counts;
+        for (auto v : x)
+        {
+            if (v >= IntType(counts.size()))
+                counts.resize(v + 1, 0);
+            ++counts[v];
+        }
+        return counts;
+    }
+
+    // M*c/r, where M is the number of arrangements of r elements, c of them
+    // equal to some v: the number of those arrangements that start with v.
+    // It's an integer, and M*c might not fit.
+    static size_type starting_with(size_type M, IntType c, IntType r)
+    {
+        return (M/r)*c + (M%r)*c/r;
+    }
+
+}; // end class MultisetPermutations
+
+////////////////////////////////////////////////////////////
+/// \brief The distinct rearrangements of the elements of X, which can have
+/// repetitions (compared with < and ==), in lexicographic order.
+///
+/// # Example:
+///
+///     std::string word = "aab";
+///     for (auto&& x : multiset_permutations(word))
+///     {
+///         for (auto c : x)
+///             cout << c;
+///         cout << ' ';
+///     }
+///
+/// Prints out:
+///
+///     aab aba baa
+///
+/// The (sorted) distinct elements of X are copied once, and the result owns
+/// them.
+////////////////////////////////////////////////////////////
+template <class Container, typename = EnableIfNotIntegral<std::decay_t<Container>>>
+auto multiset_permutations(const Container& X)
+{
+    using object = typename std::decay_t<Container>::value_type;
+    std::vector<object> distinct(X.begin(), X.end());
+    std::sort(distinct.begin(), distinct.end());
+
+    std::vector<int> counts;
+    auto first = distinct.begin();
+    auto out = distinct.begin();
+    while (first != distinct.end())
+    {
+        auto last = std::upper_bound(first, distinct.end(), *first);
+        counts.push_back(last - first);
+        if (out != first)
+            *out = std::move(*first);
+        ++out;
+        first = last;
+    }
+    distinct.erase(out, distinct.end());
+
+    return indexed_view_container(std::move(distinct), MultisetPermutations<int>(counts));
+}
+
+} // namespace discreture
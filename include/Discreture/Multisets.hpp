@@ -1,6 +1,7 @@
 #pragma once
 #include "IntegerInterval.hpp"
 #include "Misc.hpp"
+#include "Probability.hpp"
 #include "VectorHelpers.hpp"
 #include "detail/MultisetsDetail.hpp"
 #include <boost/iterator/iterator_facade.hpp>
@@ -43,6 +44,20 @@ namespace discreture
  *	[ 0 0 3 1 ]
  *	[ 1 0 3 1 ]
  *
+ *Multisets(total, k) only has the submultisets of size k (the x with
+ *x[0]+x[1]+... == k), in the same order, so with multisets X({1,0,3,1}, 2)
+ *the loop above prints out
+ *
+ *	[ 1 0 1 0 ]
+ *	[ 0 0 2 0 ]
+ *	[ 1 0 0 1 ]
+ *	[ 0 0 1 1 ]
+ *
+ *These are the distinct k-subsets of a set with repetitions. They are counted
+ *by bounded compositions: a table W(i,m) of the ways to add up to m with
+ *x[0],...,x[i-1] is computed on construction, in O(n*k), and it gives size()
+ *and random access.
+ *
  */
 
 template <class IntType = int, class RAContainerInt = std::vector<IntType>>
@@ -75,20 +90,57 @@ public:
         : total_(size, n), size_(std::pow(n + 1, size))
     {}
 
+    //////////////////////////////
+    /// @brief Only the submultisets of set that have size k.
+    ///
+    /// @note Write Multisets(multiset{a}, k) for a single element: with
+    /// Multisets({a}, k), {a} is taken to be an integer.
+    //////////////////////////////
+    Multisets(const multiset& set, IntType k)
+        : total_(set), k_(k), ways_(ways_table(set, k))
+    {
+        assert(k >= 0);
+        size_ = ways_.back();
+    }
+
+    //////////////////////////////
+    /// @brief The number of submultisets of total of size k, that is, of
+    /// compositions of k with total.size() parts, the i-th one between 0 and
+    /// total[i].
+    //////////////////////////////
+    static size_type count(const multiset& total, IntType k)
+    {
+        if (k < 0)
+            return 0;
+        return ways_table(total, k).back();
+    }
+
     size_type size() const { return size_; }
 
-    iterator begin() const { return iterator(total_); }
+    //////////////////////////////
+    /// @brief The size of the submultisets, or -1 if they have any size.
+    //////////////////////////////
+    IntType get_k() const { return k_; }
+
+    iterator begin() const
+    {
+        return k_ < 0 ? iterator(total_) : iterator(total_, *this);
+    }
 
     const iterator end() const
     {
-        return iterator::make_invalid_with_id(size());
+        return k_ < 0 ? iterator::make_invalid_with_id(size()) : begin() + size();
     }
 
-    reverse_iterator rbegin() const { return reverse_iterator(total_); }
+    reverse_iterator rbegin() const
+    {
+        return k_ < 0 ? reverse_iterator(total_) : reverse_iterator(total_, *this);
+    }
 
     const reverse_iterator rend() const
     {
-        return reverse_iterator::make_invalid_with_id(size());
+        return k_ < 0 ? reverse_iterator::make_invalid_with_id(size())
+                      : rbegin() + size();
     }
 
     //////////////////////////////
@@ -99,10 +151,38 @@ public:
     {
         assert(m >= 0 && m < size());
         multiset sub(total_.size());
-        construct_multiset(sub, total_, m);
+        if (k_ < 0)
+            construct_multiset(sub, total_, m);
+        else
+            construct_multiset_of_size(sub, m);
         return sub;
     }
 
+    //////////////////////////////
+    /// @brief A uniformly random multiset: every coordinate is independent
+    /// and uniform in [0, total[i]]. (Or uniform among those of size k.)
+    /// @param engine is any uniform random bit generator.
+    //////////////////////////////
+    template <class Engine>
+    multiset random(Engine& engine) const
+    {
+        if (k_ >= 0)
+        {
+            std::uniform_int_distribution<size_type> d(0, size_ - 1);
+            return (*this)[d(engine)];
+        }
+
+        multiset sub(total_.size());
+        for (size_t i = 0; i < total_.size(); ++i)
+        {
+            std::uniform_int_distribution<IntType> d(0, total_[i]);
+            sub[i] = d(engine);
+        }
+        return sub;
+    }
+
+    multiset random() const { return random(random::random_engine()); }
+
     //////////////////////////////
     /// @brief Opposite operator to operator[]
     /// @param sub given a multiset, what would it's index be?
@@ -110,6 +190,9 @@ public:
     size_type get_index(const multiset& sub) const
     {
         assert(sub.size() == total_.size());
+        if (k_ >= 0)
+            return get_index_of_size(sub);
+
         size_type coeff = 1;
         size_type result = 0;
         for (size_t i = 0; i < total_.size(); ++i)
@@ -131,6 +214,13 @@ public:
             : ID_(0), n_(total.size()), submulti_(total.size(), 0), total_(&total)
         {}
 
+        // Only the submultisets of size X.get_k()
+        iterator(const multiset& total, const Multisets& X)
+            : ID_(0), n_(total.size()), submulti_(total.size(), 0), total_(&total), sized_(&X)
+        {
+            fill_low(submulti_, total, n_, X.get_k());
+        }
+
         size_type ID() const { return ID_; }
 
         static const iterator make_invalid_with_id(size_type id)
@@ -144,13 +234,19 @@ public:
         void increment()
         {
             ++ID_;
-            next_multiset(submulti_, *total_, n_);
+            if (sized_)
+                next_multiset_of_size(submulti_, *total_, n_);
+            else
+                next_multiset(submulti_, *total_, n_);
         }
 
         void decrement()
         {
             --ID_;
-            prev_multiset(submulti_, *total_, n_);
+            if (sized_)
+                prev_multiset_of_size(submulti_, *total_, n_);
+            else
+                prev_multiset(submulti_, *total_, n_);
         }
 
         const multiset& dereference() const { return submulti_; }
@@ -161,7 +257,16 @@ public:
         void advance(difference_type m)
         {
             ID_ += m;
-            construct_multiset(submulti_, *total_, ID_);
+            if (!sized_)
+                construct_multiset(submulti_, *total_, ID_);
+            else if (ID_ < sized_->size())
+                sized_->construct_multiset_of_size(submulti_, ID_);
+            else if (ID_ == sized_->size())
+            {
+                // end(): the first one, which is what stepping past the last
+                // one wraps to, so that decrementing gives the last one
+                fill_low(submulti_, *total_, n_, sized_->get_k());
+            }
         }
 
         difference_type distance_to(const iterator& it) const
@@ -174,6 +279,7 @@ public:
         size_type n_{0};
         multiset submulti_{};
         multiset const* total_{nullptr};
+        Multisets const* sized_{nullptr};
 
         friend class boost::iterator_core_access;
     };
@@ -190,6 +296,13 @@ public:
             : ID_(0), n_(total.size()), submulti_(total), total_(&total)
         {}
 
+        // Only the submultisets of size X.get_k()
+        reverse_iterator(const multiset& total, const Multisets& X)
+            : ID_(0), n_(total.size()), submulti_(total.size(), 0), total_(&total), sized_(&X)
+        {
+            fill_high(submulti_, total, n_, X.get_k());
+        }
+
         size_type ID() const { return ID_; }
 
         static const reverse_iterator make_invalid_with_id(size_type id)
@@ -204,17 +317,39 @@ public:
         void increment()
         {
             ++ID_;
-            prev_multiset(submulti_, *total_, n_);
+            if (sized_)
+                prev_multiset_of_size(submulti_, *total_, n_);
+            else
+                prev_multiset(submulti_, *total_, n_);
         }
 
         void decrement()
         {
             --ID_;
-            next_multiset(submulti_, *total_, n_);
+            if (sized_)
+                next_multiset_of_size(submulti_, *total_, n_);
+            else
+                next_multiset(submulti_, *total_, n_);
         }
 
         void advance(difference_type m)
         {
+            if (sized_)
+            {
+                ID_ += m;
+                if (ID_ < sized_->size())
+                    sized_->construct_multiset_of_size(submulti_,
+                                                       sized_->size() - ID_ - 1);
+                else if (ID_ == sized_->size())
+                {
+                    // rend(): the last one, which is what stepping past the
+                    // first one wraps to, so that decrementing gives the
+                    // first one
+                    fill_high(submulti_, *total_, n_, sized_->get_k());
+                }
+                return;
+            }
+
             size_type s = 1;
             for (auto x : *total_)
                 s *= (x + 1);
@@ -237,6 +372,7 @@ public:
         size_type n_{0}; // must have n_ = submulti_.size() = total_->size()
         multiset submulti_{};
         multiset const* total_{nullptr};
+        Multisets const* sized_{nullptr};
 
         friend class boost::iterator_core_access;
     };
@@ -244,6 +380,12 @@ public:
     template <class Func>
     void for_each(Func f) const
     {
+        if (k_ >= 0)
+        {
+            for_each_of_size(f);
+            return;
+        }
+
         switch (total_.size())
         {
             // clang-format off
@@ -317,6 +459,60 @@ public:
         }
     }
 
+    //////////////////////////////
+    /// @brief The next submultiset with the same size as sub, in the same
+    /// order as next_multiset (the last one goes back to the first).
+    //////////////////////////////
+    static void next_multiset_of_size(multiset& sub, const multiset& total, size_type n)
+    {
+        assert(n == size_type(sub.size()));
+        assert(n == size_type(total.size()));
+        if (n == 0)
+            return;
+
+        // Increase the first sub[j] that can take one from sub[0..j), and
+        // make sub[0..j) as small as possible with what is left.
+        IntType below = sub[0];
+        for (size_type j = 1; j < n; ++j)
+        {
+            if (below > 0 && sub[j] < total[j])
+            {
+                ++sub[j];
+                fill_low(sub, total, j, below - 1);
+                return;
+            }
+            below += sub[j];
+        }
+        fill_low(sub, total, n, below);
+    }
+
+    //////////////////////////////
+    /// @brief The previous submultiset with the same size as sub (the first
+    /// one goes to the last).
+    //////////////////////////////
+    static void prev_multiset_of_size(multiset& sub, const multiset& total, size_type n)
+    {
+        assert(n == size_type(sub.size()));
+        assert(n == size_type(total.size()));
+        if (n == 0)
+            return;
+
+        IntType below = sub[0];
+        IntType room = total[0] - sub[0]; // free space in sub[0..j)
+        for (size_type j = 1; j < n; ++j)
+        {
+            if (sub[j] > 0 && room > 0)
+            {
+                --sub[j];
+                fill_high(sub, total, j, below + 1);
+                return;
+            }
+            below += sub[j];
+            room += total[j] - sub[j];
+        }
+        fill_high(sub, total, n, below);
+    }
+
     static void construct_multiset(multiset& sub,
                                    const multiset& total,
                                    size_type m)
@@ -351,6 +547,125 @@ public:
 private:
     multiset total_;
     size_type size_;
+    IntType k_{-1}; // -1 for every size
+    std::vector<size_type> ways_{}; // W(i,m) = ways_[i*(k_ + 1) + m]
+
+    // The ways to add up to m = 0, ..., k with x[0] <= total[0], ...,
+    // x[i-1] <= total[i-1], for i = 0, ..., n.
+    static std::vector<size_type> ways_table(const multiset& total, IntType k)
+    {
+        size_type n = total.size();
+        size_type w = std::max<IntType>(k, 0) + 1;
+        std::vector<size_type> W((n + 1)*w, 0);
+        W[0] = 1;
+        for (size_type i = 0; i < n; ++i)
+        {
+            // W(i+1,m) = W(i,m) + W(i,m-1) + ... + W(i,m-total[i])
+            for (size_type m = 0; m < w; ++m)
+            {
+                size_type result = W[i*w + m];
+                if (m > 0)
+                    result += W[(i + 1)*w + m - 1];
+                if (m > total[i])
+                    result -= W[i*w + m - total[i] - 1];
+                W[(i + 1)*w + m] = result;
+            }
+        }
+        return W;
+    }
+
+    size_type ways(size_type i, IntType m) const
+    {
+        return m < 0 ? 0 : ways_[i*(k_ + 1) + m];
+    }
+
+    // Puts as much as possible in sub[0], then in sub[1], ...
+    static void fill_low(multiset& sub, const multiset& total, size_type j, IntType amount)
+    {
+        for (size_type i = 0; i < j; ++i)
+        {
+            sub[i] = std::min(total[i], amount);
+            amount -= sub[i];
+        }
+    }
+
+    // Puts as much as possible in sub[j-1], then in sub[j-2], ...
+    static void fill_high(multiset& sub, const multiset& total, size_type j, IntType amount)
+    {
+        for (size_type i = j - 1; i >= 0; --i)
+        {
+            sub[i] = std::min(total[i], amount);
+            amount -= sub[i];
+        }
+    }
+
+    void construct_multiset_of_size(multiset& sub, size_type m) const
+    {
+        IntType left = k_;
+        for (size_type i = total_.size() - 1; i >= 0; --i)
+        {
+            IntType v = 0;
+            while (ways(i, left - v) <= m)
+            {
+                m -= ways(i, left - v);
+                ++v;
+            }
+            sub[i] = v;
+            left -= v;
+        }
+    }
+
+    size_type get_index_of_size(const multiset& sub) const
+    {
+        size_type result = 0;
+        IntType left = k_;
+        for (size_type i = total_.size() - 1; i >= 0; --i)
+        {
+            for (IntType v = 0; v < sub[i]; ++v)
+                result += ways(i, left - v);
+            left -= sub[i];
+        }
+        return result;
+    }
+
+    template <class Func>
+    void for_each_of_size(Func f) const
+    {
+        switch (total_.size())
+        {
+            // clang-format off
+        case 0: detail::for_each_multiset_of_size<multiset,0>::apply(total_,k_,f); break;
+        case 1: detail::for_each_multiset_of_size<multiset,1>::apply(total_,k_,f); break;
+        case 2: detail::for_each_multiset_of_size<multiset,2>::apply(total_,k_,f); break;
+        case 3: detail::for_each_multiset_of_size<multiset,3>::apply(total_,k_,f); break;
+        case 4: detail::for_each_multiset_of_size<multiset,4>::apply(total_,k_,f); break;
+        case 5: detail::for_each_multiset_of_size<multiset,5>::apply(total_,k_,f); break;
+        case 6: detail::for_each_multiset_of_size<multiset,6>::apply(total_,k_,f); break;
+        case 7: detail::for_each_multiset_of_size<multiset,7>::apply(total_,k_,f); break;
+        case 8: detail::for_each_multiset_of_size<multiset,8>::apply(total_,k_,f); break;
+        case 9: detail::for_each_multiset_of_size<multiset,9>::apply(total_,k_,f); break;
+        case 10: detail::for_each_multiset_of_size<multiset,10>::apply(total_,k_,f); break;
+        case 11: detail::for_each_multiset_of_size<multiset,11>::apply(total_,k_,f); break;
+        case 12: detail::for_each_multiset_of_size<multiset,12>::apply(total_,k_,f); break;
+        case 13: detail::for_each_multiset_of_size<multiset,13>::apply(total_,k_,f); break;
+        case 14: detail::for_each_multiset_of_size<multiset,14>::apply(total_,k_,f); break;
+        case 15: detail::for_each_multiset_of_size<multiset,15>::apply(total_,k_,f); break;
+        case 16: detail::for_each_multiset_of_size<multiset,16>::apply(total_,k_,f); break;
+        case 17: detail::for_each_multiset_of_size<multiset,17>::apply(total_,k_,f); break;
+        case 18: detail::for_each_multiset_of_size<multiset,18>::apply(total_,k_,f); break;
+        case 19: detail::for_each_multiset_of_size<multiset,19>::apply(total_,k_,f); break;
+        case 20: detail::for_each_multiset_of_size<multiset,20>::apply(total_,k_,f); break;
+            // clang-format on
+
+        default:
+            for (auto& x : (*this))
+            {
+                f(x);
+            }
+
+            break;
+        }
+    }
 
     static bool can_increment(size_t index,
                               const multiset& sub,
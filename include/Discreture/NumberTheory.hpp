@@ -0,0 +1,550 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "detail/WideMultiply.hpp"
+
+namespace discreture
+{
+
+//////////////////////////////////////////
+/// \brief A prime p together with its exponent a in some factorization.
+//////////////////////////////////////////
+struct prime_power
+{
+    std::uint64_t p;
+    int a;
+};
+
+inline bool operator==(const prime_power& lhs, const prime_power& rhs)
+{
+    return lhs.p == rhs.p && lhs.a == rhs.a;
+}
+
+inline bool operator!=(const prime_power& lhs, const prime_power& rhs)
+{
+    return !(lhs == rhs);
+}
+
+//////////////////////////////////////////
+/// \brief Prime factorization, as prime powers in increasing order of prime.
+//////////////////////////////////////////
+using factorization = std::vector<prime_power>;
+
+//////////////////////////////////////////
+/// \brief floor(sqrt(n)), exactly, for any 64-bit n.
+//////////////////////////////////////////
+inline std::uint64_t isqrt(std::uint64_t n)
+{
+    auto r = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+    while (r > 0 && (r > 0xFFFFFFFFULL || r*r > n))
+        --r;
+    while (r < 0xFFFFFFFFULL && (r + 1)*(r + 1) <= n)
+        ++r;
+    return r;
+}
+
+namespace detail
+{
+    // Sieving is done on odd numbers only, one byte per number, in segments
+    // that fit in L1 cache.
+    constexpr std::size_t sieve_segment_bytes = 1 << 15;
+
+    inline std::uint64_t binary_gcd(std::uint64_t a, std::uint64_t b)
+    {
+        if (a == 0)
+            return b;
+        if (b == 0)
+            return a;
+
+        int shift = ctz64(a | b);
+        a >>= ctz64(a);
+        while (b != 0)
+        {
+            b >>= ctz64(b);
+            if (a > b)
+                std::swap(a, b);
+            b -= a;
+        }
+        return a << shift;
+    }
+
+    // Splits [lo,hi) in num_threads contiguous parts and calls
+    // f(part_lo, part_hi, part) for each one in its own thread.
+    template <class F>
+    void for_each_chunk(std::uint64_t lo,
+                        std::uint64_t hi,
+                        std::size_t num_threads,
+                        F f)
+    {
+        std::uint64_t length = hi > lo ? hi - lo : 0;
+        num_threads = std::max<std::size_t>(1, num_threads);
+        if (num_threads == 1 || length < num_threads)
+        {
+            f(lo, hi, std::size_t(0));
+            for (std::size_t i = 1; i < num_threads; ++i)
+                f(hi, hi, i);
+            return;
+        }
+
+        std::uint64_t chunk = (length + num_threads - 1)/num_threads;
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i)
+        {
+            std::uint64_t a = std::min(hi, lo + i*chunk);
+            std::uint64_t b = std::min(hi, a + chunk);
+            threads.emplace_back([&f, a, b, i]() { f(a, b, i); });
+        }
+
+        for (auto& t : threads)
+            t.join();
+    }
+
+    // Odd primes up to limit, with a plain sieve. Only used to get the primes
+    // that sieve the segments.
+    inline std::vector<std::uint32_t> base_odd_primes(std::uint64_t limit)
+    {
+        std::vector<std::uint32_t> primes;
+        if (limit < 3)
+            return primes;
+
+        std::vector<unsigned char> composite(limit/2 + 1, 0); // i -> 2i+1
+        for (std::uint64_t i = 1; (2*i + 1)*(2*i + 1) <= limit; ++i)
+        {
+            if (composite[i])
+                continue;
+            std::uint64_t p = 2*i + 1;
+            for (std::uint64_t j = p*p/2; j <= limit/2; j += p)
+                composite[j] = 1;
+        }
+
+        for (std::uint64_t i = 1; 2*i + 1 <= limit; ++i)
+            if (!composite[i])
+                primes.push_back(2*i + 1);
+
+        return primes;
+    }
+
+    // Calls f(p) for every prime p in [lo,hi), in increasing order. base
+    // must contain all odd primes up to sqrt(hi-1).
+    template <class F>
+    void sieve_range(std::uint64_t lo,
+                     std::uint64_t hi,
+                     const std::vector<std::uint32_t>& base,
+                     F f)
+    {
+        if (lo <= 2 && 2 < hi)
+            f(std::uint64_t(2));
+
+        lo = std::max<std::uint64_t>(lo, 3);
+        lo |= 1;
+        if (lo >= hi)
+            return;
+
+        // next[i] is the next odd multiple of base[i] to cross out, as an
+        // index into the odd numbers starting at lo.
+        std::vector<std::uint64_t> next(base.size());
+        for (std::size_t i = 0; i < base.size(); ++i)
+        {
+            std::uint64_t p = base[i];
+            std::uint64_t start = std::max(p*p, (lo + p - 1)/p*p);
+            if (start%2 == 0)
+                start += p;
+            next[i] = (start - lo)/2;
+        }
+
+        const std::uint64_t total = (hi - lo + 1)/2;
+        std::vector<unsigned char> segment(sieve_segment_bytes);
+
+        for (std::uint64_t first = 0; first < total; first += sieve_segment_bytes)
+        {
+            std::uint64_t last = std::min(total, first + sieve_segment_bytes);
+            std::fill(segment.begin(), segment.begin() + (last - first), 1);
+
+            for (std::size_t i = 0; i < base.size(); ++i)
+            {
+                std::uint64_t p = base[i];
+                std::uint64_t j = next[i];
+                if (j >= last)
+                    continue;
+                for (; j < last; j += p)
+                    segment[j - first] = 0;
+                next[i] = j;
+            }
+
+            for (std::uint64_t j = first; j < last; ++j)
+                if (segment[j - first])
+                    f(lo + 2*j);
+        }
+    }
+
+    // Multiplication modulo an odd 64-bit n, in Montgomery form (x is
+    // represented by xR mod n, with R = 2^64).
+    class montgomery64
+    {
+    public:
+        explicit montgomery64(std::uint64_t n) : n_(n), inv_(n)
+        {
+            // Newton's iteration doubles the number of correct bits each
+            // time: 3 -> 6 -> 12 -> 24 -> 48 -> 96.
+            for (int i = 0; i < 5; ++i)
+                inv_ *= 2 - n_*inv_;
+
+            std::uint64_t r1 = (0 - n_)%n_; // 2^64 mod n
+            r2_ = mulmod64(r1, r1, n_);
+            one_ = r1;
+        }
+
+        std::uint64_t modulus() const { return n_; }
+
+        std::uint64_t one() const { return one_; }
+
+        std::uint64_t to(std::uint64_t x) const { return mul(x%n_, r2_); }
+
+        std::uint64_t from(std::uint64_t x) const { return reduce(0, x); }
+
+        // t = hi*2^64 + lo < n*2^64
+        std::uint64_t reduce(std::uint64_t hi, std::uint64_t lo) const
+        {
+            std::uint64_t m = lo*inv_;
+            std::uint64_t mn = mulhi64(m, n_);
+            std::uint64_t r = hi - mn;
+            if (hi < mn)
+                r += n_;
+            return r;
+        }
+
+        std::uint64_t mul(std::uint64_t a, std::uint64_t b) const
+        {
+            std::uint64_t hi;
+            std::uint64_t lo = mul128(a, b, hi);
+            return reduce(hi, lo);
+        }
+
+        std::uint64_t add(std::uint64_t a, std::uint64_t b) const
+        {
+            std::uint64_t s = a + b;
+            if (s >= n_ || s < a)
+                s -= n_;
+            return s;
+        }
+
+        std::uint64_t pow(std::uint64_t a, std::uint64_t e) const
+        {
+            std::uint64_t r = one_;
+            while (e > 0)
+            {
+                if (e & 1)
+                    r = mul(r, a);
+                a = mul(a, a);
+                e >>= 1;
+            }
+            return r;
+        }
+
+    private:
+        std::uint64_t n_;
+        std::uint64_t inv_; // n*inv = 1 mod 2^64
+        std::uint64_t r2_;  // 2^128 mod n
+        std::uint64_t one_; // 2^64 mod n
+    };
+
+    constexpr std::uint32_t small_primes[] = {2,  3,  5,  7,  11, 13, 17, 19, 23, 29, 31, 37, 41,
+                                              43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97};
+
+    // Some factor 1 < d < n of an odd composite n (which may or may not be
+    // prime), using Brent's variant of Pollard's rho.
+    inline std::uint64_t pollard_brent(std::uint64_t n)
+    {
+        const montgomery64 M(n);
+        const std::uint64_t batch = 128;
+
+        auto dist = [](std::uint64_t x, std::uint64_t y) {
+            return x > y ? x - y : y - x;
+        };
+
+        for (std::uint64_t c0 = 1;; ++c0)
+        {
+            const std::uint64_t c = M.to(c0);
+            auto f = [&M, c](std::uint64_t x) { return M.add(M.mul(x, x), c); };
+
+            std::uint64_t x = 0, y = M.to(c0 + 1), ys = 0, q = M.one(), g = 1;
+
+            for (std::uint64_t r = 1; g == 1; r *= 2)
+            {
+                x = y;
+                for (std::uint64_t i = 0; i < r; ++i)
+                    y = f(y);
+
+                for (std::uint64_t k = 0; k < r && g == 1; k += batch)
+                {
+                    ys = y;
+                    for (std::uint64_t i = 0; i < std::min(batch, r - k); ++i)
+                    {
+                        y = f(y);
+                        q = M.mul(q, dist(x, y));
+                    }
+                    // gcd(qR,n) == gcd(q,n), so no need to leave Montgomery form
+                    g = binary_gcd(q, n);
+                }
+            }
+
+            if (g == n)
+            {
+                // The batch overshot: redo it one step at a time.
+                do
+                {
+                    ys = f(ys);
+                    g = binary_gcd(dist(x, ys), n);
+                } while (g == 1);
+            }
+
+            if (g != n)
+                return g;
+        }
+    }
+
+} // namespace detail
+
+//////////////////////////////////////////
+/// \brief Deterministic primality test for any 64-bit number.
+///
+/// Trial division by the primes below 100, then Miller-Rabin with the seven
+/// bases of Jim Sinclair, which have no strong pseudoprimes below 2^64.
+/// Multiplications modulo n use Montgomery reduction, so there is no
+/// overflow and no division in the inner loop.
+//////////////////////////////////////////
+inline bool is_prime(std::uint64_t n)
+{
+    if (n < 2)
+        return false;
+
+    for (auto p : detail::small_primes)
+    {
+        if (n%p == 0)
+            return n == p;
+    }
+
+    if (n < 101*101)
+        return true;
+
+    const detail::montgomery64 M(n);
+    std::uint64_t d = n - 1;
+    int s = detail::ctz64(d);
+    d >>= s;
+
+    const std::uint64_t one = M.one();
+    const std::uint64_t minus_one = n - one; // -R mod n
+
+    for (std::uint64_t a : {2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL})
+    {
+        a %= n;
+        if (a == 0)
+            continue;
+
+        std::uint64_t x = M.pow(M.to(a), d);
+        if (x == one || x == minus_one)
+            continue;
+
+        bool composite = true;
+        for (int i = 1; i < s && composite; ++i)
+        {
+            x = M.mul(x, x);
+            if (x == minus_one)
+                composite = false;
+        }
+
+        if (composite)
+            return false;
+    }
+
+    return true;
+}
+
+//////////////////////////////////////////
+/// \brief The prime factorization of n, for any 64-bit n.
+///
+/// Trial division by the primes below 100, then Pollard-Brent rho with
+/// Montgomery multiplication on whatever is left. Returns an empty
+/// factorization for n = 0 and n = 1.
+//////////////////////////////////////////
+inline factorization factorize(std::uint64_t n)
+{
+    factorization F;
+    if (n < 2)
+        return F;
+
+    for (std::uint64_t p : detail::small_primes)
+    {
+        int a = 0;
+        while (n%p == 0)
+        {
+            n /= p;
+            ++a;
+        }
+        if (a > 0)
+            F.push_back({p, a});
+    }
+
+    std::vector<std::uint64_t> large;
+    std::vector<std::uint64_t> pending;
+    if (n > 1)
+        pending.push_back(n);
+
+    while (!pending.empty())
+    {
+        auto m = pending.back();
+        pending.pop_back();
+
+        if (is_prime(m))
+        {
+            large.push_back(m);
+            continue;
+        }
+
+        auto d = detail::pollard_brent(m);
+        pending.push_back(d);
+        pending.push_back(m/d);
+    }
+
+    std::sort(large.begin(), large.end());
+    for (auto p : large)
+    {
+        if (!F.empty() && F.back().p == p)
+            ++F.back().a;
+        else
+            F.push_back({p, 1});
+    }
+
+    return F;
+}
+
+//////////////////////////////////////////
+/// \brief Calls f(p) for every prime p in [lo,hi), in increasing order.
+///
+/// Segmented sieve of Eratosthenes on odd numbers, in segments that fit in
+/// L1 cache, so it takes O(sqrt(hi)) memory no matter how long the range is.
+//////////////////////////////////////////
+template <class F>
+void for_each_prime(std::uint64_t lo, std::uint64_t hi, F f)
+{
+    if (hi <= lo)
+        return;
+    auto base = detail::base_odd_primes(isqrt(hi - 1));
+    detail::sieve_range(lo, hi, base, f);
+}
+
+//////////////////////////////////////////
+/// \brief All primes in [lo,hi), in increasing order.
+///
+/// \param num_threads splits the range into that many parts, sieved in
+/// parallel.
+//////////////////////////////////////////
+inline std::vector<std::uint64_t>
+primes_in_range(std::uint64_t lo, std::uint64_t hi, std::size_t num_threads = 1)
+{
+    std::vector<std::uint64_t> result;
+    if (hi <= lo)
+        return result;
+
+    const auto base = detail::base_odd_primes(isqrt(hi - 1));
+    num_threads = std::max<std::size_t>(1, num_threads);
+    std::vector<std::vector<std::uint64_t>> parts(num_threads);
+
+    detail::for_each_chunk(lo, hi, num_threads, [&](std::uint64_t a, std::uint64_t b, std::size_t i) {
+        // prime number theorem, with some slack
+        double estimate = b > a ? 1.2*(b - a)/std::log(std::max<double>(b, 3.0)) + 16 : 0;
+        parts[i].reserve(static_cast<std::size_t>(estimate));
+        detail::sieve_range(a, b, base, [&parts, i](std::uint64_t p) {
+            parts[i].push_back(p);
+        });
+    });
+
+    if (num_threads == 1)
+        return std::move(parts[0]);
+
+    std::size_t total = 0;
+    for (auto& part : parts)
+        total += part.size();
+    result.reserve(total);
+    for (auto& part : parts)
+        result.insert(result.end(), part.begin(), part.end());
+
+    return result;
+}
+
+//////////////////////////////////////////
+/// \brief All primes p <= n, in increasing order.
+//////////////////////////////////////////
+inline std::vector<std::uint64_t> primes_up_to(std::uint64_t n,
+                                               std::size_t num_threads = 1)
+{
+    return primes_in_range(0, n + 1, num_threads);
+}
+
+//////////////////////////////////////////
+/// \brief The factorizations of every number in [lo,hi), so that
+/// result[i] is the factorization of lo+i.
+///
+/// Much faster than calling factorize on each one: every prime p up to
+/// sqrt(hi) is only tried on the multiples of p. The range is processed in
+/// cache-sized blocks, split among num_threads threads.
+//////////////////////////////////////////
+inline std::vector<factorization>
+factorize_range(std::uint64_t lo, std::uint64_t hi, std::size_t num_threads = 1)
+{
+    std::vector<factorization> result(hi > lo ? hi - lo : 0);
+    if (hi <= lo)
+        return result;
+
+    auto base = detail::base_odd_primes(isqrt(hi - 1));
+    base.insert(base.begin(), 2);
+
+    detail::for_each_chunk(lo, hi, num_threads, [&](std::uint64_t a, std::uint64_t b, std::size_t) {
+        const std::uint64_t block = detail::sieve_segment_bytes/sizeof(std::uint64_t);
+        std::vector<std::uint64_t> rest(block);
+
+        for (std::uint64_t first = a; first < b; first += block)
+        {
+            std::uint64_t last = std::min(b, first + block);
+            for (std::uint64_t m = first; m < last; ++m)
+                rest[m - first] = m;
+
+            for (std::uint64_t p : base)
+            {
+                if (p*p >= last)
+                    break;
+
+                for (std::uint64_t m = (first + p - 1)/p*p; m < last; m += p)
+                {
+                    auto& r = rest[m - first];
+                    if (r == 0)
+                        continue;
+                    int e = 0;
+                    do
+                    {
+                        r /= p;
+                        ++e;
+                    } while (r%p == 0);
+                    result[m - lo].push_back({p, e});
+                }
+            }
+
+            for (std::uint64_t m = first; m < last; ++m)
+            {
+                if (rest[m - first] > 1)
+                    result[m - lo].push_back({rest[m - first], 1});
+            }
+        }
+    });
+
+    return result;
+}
+
+} // namespace discreture
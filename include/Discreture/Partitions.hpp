@@ -2,6 +2,7 @@
 
 #include "ArithmeticProgression.hpp"
 #include "Misc.hpp"
+#include "Probability.hpp"
 #include "Reversed.hpp"
 #include "Sequences.hpp"
 #include "VectorHelpers.hpp"
@@ -91,6 +92,73 @@ public:
 
     IntType get_n() const { return n_; }
 
+    ////////////////////////////////////////////////////////////
+    /// \brief A uniformly random partition (with the allowed number of
+    /// parts).
+    ///
+    /// Uses the recursive method of Nijenhuis and Wilf: a partition of n into
+    /// exactly k parts either has a part equal to 1 (remove it) or all of its
+    /// parts are >= 2 (subtract 1 from each). Choosing each case with the
+    /// right probability gives O(n) time and no rejections. (Plus O(n*k) if
+    /// the partition numbers don't fit in an llint.)
+    ///
+    /// \param engine is any uniform random bit generator.
+    ////////////////////////////////////////////////////////////
+    template <class Engine>
+    partition random(Engine& engine) const
+    {
+        if (n_ == 0)
+            return partition();
+
+        // the partition numbers can be too big for an llint, so use logarithms
+        detail::log_counts<detail::partition_rule> log_p(&partition_number<llint>, n_,
+                                                         min_num_parts_, max_num_parts_);
+
+        std::vector<double> weights;
+        for (IntType k = min_num_parts_; k <= max_num_parts_; ++k)
+            weights.push_back(log_p(n_, k));
+        double top = *std::max_element(weights.begin(), weights.end());
+        for (auto& w : weights)
+            w = std::exp(w - top);
+
+        std::discrete_distribution<IntType> choose_k(weights.begin(),
+                                                     weights.end());
+        IntType k = min_num_parts_ + choose_k(engine);
+        IntType n = n_;
+
+        // parts are found from smallest to largest
+        partition result;
+        IntType lift = 0;
+        std::uniform_real_distribution<double> U(0.0, 1.0);
+        while (k > 0)
+        {
+            if (k == 1)
+            {
+                result.push_back(n + lift);
+                break;
+            }
+
+            double p_one = std::exp(log_p(n - 1, k - 1) - log_p(n, k));
+
+            if (U(engine) < p_one)
+            {
+                result.push_back(1 + lift);
+                --n;
+                --k;
+            }
+            else
+            {
+                n -= k;
+                ++lift;
+            }
+        }
+
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    partition random() const { return random(random::random_engine()); }
+
     iterator begin() const { return iterator(n_, max_num_parts_); }
 
     const iterator end() const
@@ -374,7 +442,7 @@ private:
     {
         size_type toReturn = 0;
         for (size_type k = minnumparts; k <= maxnumparts; ++k)
-            toReturn += partition_number(n, k);
+            toReturn = detail::saturating_add(toReturn, partition_number(n, k));
         return toReturn;
     }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "ArithmeticProgression.hpp"
+#include "Calibration.hpp"
 #include "IndexedViewContainer.hpp"
 #include "Misc.hpp"
 #include "Probability.hpp"
@@ -122,15 +123,18 @@ public:
     ////////////////////////////////////////////////////////////
     /// \brief Constructs a random permutation of {0,1,2,...,n-1}
     ////////////////////////////////////////////////////////////
-    permutation random() const
+    template <class Engine>
+    permutation random(Engine& engine) const
     {
         permutation a = identity();
 
-        std::shuffle(a.begin(), a.end(), random::random_engine());
+        std::shuffle(a.begin(), a.end(), engine);
 
         return a;
     }
 
+    permutation random() const { return random(random::random_engine()); }
+
     /////////////////////////////////////////////////////////////////////////////
     /// \brief Returns the ID of the iterator whose value is perm. That is, the
     /// index of permutation perm in the lexicographic order.
@@ -254,7 +258,7 @@ public:
         {
             assert(0 <= n + ID_);
 
-            if (std::abs(n) < 20)
+            if (std::abs(n) < crossover_threshold(last_ + 1))
             {
                 while (n > 0)
                 {
@@ -351,7 +355,7 @@ public:
         {
             assert(0 <= m + ID_);
 
-            if (std::abs(m) < 10) // found experimentally
+            if (std::abs(m) < reverse_crossover_threshold(data_.size()))
             {
                 while (m > 0)
                 {
@@ -425,9 +429,62 @@ public:
         }
     }
 
+    ////////////////////////////////////////////////////////////
+    /// \brief The smallest distance for which iterator::advance constructs
+    /// the permutation from scratch instead of stepping to it. Measured the
+    /// first time it's needed for each n (see crossover_table()).
+    ////////////////////////////////////////////////////////////
+    static difference_type crossover_threshold(IntType n)
+    {
+        return crossover_table().get(crossover_family::permutations, n, [n]() {
+            return measure_crossover_threshold(n, false);
+        });
+    }
+
+    static difference_type reverse_crossover_threshold(IntType n)
+    {
+        return crossover_table().get(crossover_family::permutations_reverse,
+                                     n,
+                                     [n]() {
+                                         return measure_crossover_threshold(n,
+                                                                            true);
+                                     });
+    }
+
 private:
     IntType n_;
 
+    static difference_type measure_crossover_threshold(IntType n, bool reverse)
+    {
+        // 20! is the largest factorial that fits in 64 bits
+        if (n < 2 || n > 20)
+            return CrossoverTable::default_threshold(
+              reverse ? crossover_family::permutations_reverse
+                      : crossover_family::permutations);
+
+        size_type total = factorial(n);
+        permutation data(n);
+        std::iota(data.begin(), data.end(), 0);
+
+        // next_permutation wraps around by itself
+        auto step = [&]() {
+            if (reverse)
+                std::prev_permutation(data.begin(), data.end());
+            else
+                std::next_permutation(data.begin(), data.end());
+        };
+
+        // Knuth's multiplicative hash, to jump around pseudo-randomly
+        auto unrank = [&](int i) {
+            size_type m = (size_type(i)*2654435761LL)%total;
+            if (reverse)
+                m = factorial(n) - m - 1;
+            construct_permutation(data, m);
+        };
+
+        return measure_crossover(step, unrank);
+    }
+
     size_type get_index(const permutation& perm, int first, int last)
     {
         if (last <= first)
@@ -458,11 +515,13 @@ using boost::container::static_vector;
 // using permutations = Permutations<int>;
 using permutations_stack = Permutations<int, static_vector<int, 16>>;
 
-template <class Container, typename = EnableIfNotIntegral<Container>>
-auto permutations(const Container& X)
+// Borrows X if it is an lvalue, takes ownership (without copying) otherwise.
+template <class Container, typename = EnableIfNotIntegral<std::decay_t<Container>>>
+auto permutations(Container&& X)
 {
     using index_permutations = Permutations<int>;
-    return indexed_view_container(X, index_permutations(X.size()));
+    index_permutations P(X.size());
+    return indexed_view_container(std::forward<Container>(X), std::move(P));
 }
 
 template <typename T, typename = EnableIfIntegral<T>>
@@ -0,0 +1,485 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Modular.hpp"
+#include "NumberTheory.hpp"
+
+namespace discreture
+{
+
+//////////////////////////////////////////
+/// \brief Truncated power series modulo a prime p = c*2^k + 1, multiplied
+/// with the number theoretic transform (NTT) in O(n log n).
+///
+/// A series is a std::vector<std::uint32_t> of coefficients (the constant
+/// term first), all smaller than p. On top of multiplication there's
+/// inverse, log and exp, all O(n log n) by Newton's method.
+///
+/// # Example:
+///
+///     PowerSeriesMod P; // mod 998244353 = 119*2^23 + 1
+///     auto c = P.multiply(a, b); // all the coefficients of a*b
+///     auto e = P.exp(f, 1000);   // first 1000 coefficients of exp(f)
+//////////////////////////////////////////
+class PowerSeriesMod
+{
+public:
+    using series = std::vector<std::uint32_t>;
+
+    explicit PowerSeriesMod(std::uint32_t p = 998244353) : B_(p)
+    {
+        assert(is_prime(p) && p > 2);
+        std::uint32_t odd = p - 1;
+        while (odd%2 == 0)
+        {
+            odd /= 2;
+            ++max_log_;
+        }
+
+        // smallest primitive root g, so g^odd has order 2^max_log_
+        auto factors = factorize(p - 1);
+        std::uint32_t g = 2;
+        while (std::any_of(factors.begin(), factors.end(), [&](const prime_power& q) {
+            return B_.pow(g, (p - 1)/q.p) == 1;
+        }))
+            ++g;
+        root_ = B_.pow(g, odd);
+    }
+
+    std::uint32_t modulus() const { return B_.modulus(); }
+
+    //////////////////////////////////////////
+    /// \brief The longest transform supported, 2^k.
+    //////////////////////////////////////////
+    std::size_t max_length() const { return std::size_t(1) << max_log_; }
+
+    //////////////////////////////////////////
+    /// \brief In place NTT (or inverse NTT) of a, whose size must be a power
+    /// of 2 no larger than max_length().
+    //////////////////////////////////////////
+    void transform(series& a, bool invert) const
+    {
+        const std::size_t n = a.size();
+        assert((n & (n - 1)) == 0 && n <= max_length());
+        if (n <= 1)
+            return;
+
+        for (std::size_t i = 1, j = 0; i < n; ++i)
+        {
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(a[i], a[j]);
+        }
+
+        // w[i] = w^i for a primitive n-th root of unity w; level len uses
+        // every (n/len)-th one.
+        std::uint32_t wn = root_of_unity(n, invert);
+        series w(n/2);
+        w[0] = 1;
+        for (std::size_t i = 1; i < n/2; ++i)
+            w[i] = B_.mul(w[i - 1], wn);
+
+        for (std::size_t len = 2; len <= n; len <<= 1)
+        {
+            const std::size_t half = len/2;
+            const std::size_t step = n/len;
+            for (std::size_t i = 0; i < n; i += len)
+            {
+                for (std::size_t j = 0; j < half; ++j)
+                {
+                    std::uint32_t u = a[i + j];
+                    std::uint32_t v = B_.mul(a[i + j + half], w[j*step]);
+                    a[i + j] = B_.add(u, v);
+                    a[i + j + half] = B_.sub(u, v);
+                }
+            }
+        }
+
+        if (invert)
+        {
+            std::uint32_t inv_n = B_.pow(static_cast<std::uint32_t>(n), modulus() - 2);
+            for (auto& x : a)
+                x = B_.mul(x, inv_n);
+        }
+    }
+
+    //////////////////////////////////////////
+    /// \brief The first n coefficients of a*b.
+    //////////////////////////////////////////
+    series multiply(const series& a, const series& b, std::size_t n) const
+    {
+        series c(n, 0);
+        std::size_t na = std::min(a.size(), n);
+        std::size_t nb = std::min(b.size(), n);
+        if (na == 0 || nb == 0)
+            return c;
+
+        if (std::min(na, nb) <= naive_threshold)
+        {
+            for (std::size_t i = 0; i < na; ++i)
+                for (std::size_t j = 0; j < nb && i + j < n; ++j)
+                    c[i + j] = B_.add(c[i + j], B_.mul(a[i], b[j]));
+            return c;
+        }
+
+        std::size_t len = 1;
+        while (len < na + nb - 1)
+            len <<= 1;
+
+        series fa(a.begin(), a.begin() + na);
+        series fb(b.begin(), b.begin() + nb);
+        fa.resize(len, 0);
+        fb.resize(len, 0);
+        transform(fa, false);
+        transform(fb, false);
+        for (std::size_t i = 0; i < len; ++i)
+            fa[i] = B_.mul(fa[i], fb[i]);
+        transform(fa, true);
+
+        std::copy(fa.begin(), fa.begin() + std::min(n, len), c.begin());
+        return c;
+    }
+
+    //////////////////////////////////////////
+    /// \brief All the coefficients of a*b.
+    //////////////////////////////////////////
+    series multiply(const series& a, const series& b) const
+    {
+        if (a.empty() || b.empty())
+            return {};
+        return multiply(a, b, a.size() + b.size() - 1);
+    }
+
+    //////////////////////////////////////////
+    /// \brief The first n coefficients of 1/a. Needs a[0] != 0.
+    //////////////////////////////////////////
+    series inverse(const series& a, std::size_t n) const
+    {
+        assert(!a.empty() && a[0] != 0);
+        series b{B_.pow(a[0], modulus() - 2)};
+
+        // b <- b(2 - ab) doubles the number of correct coefficients
+        for (std::size_t len = 1; len < n;)
+        {
+            len *= 2;
+            series a_cut(a.begin(), a.begin() + std::min(len, a.size()));
+            series c = multiply(a_cut, b, len);
+            for (auto& x : c)
+                x = B_.sub(0, x);
+            c[0] = B_.add(c[0], 2);
+            b = multiply(b, c, len);
+        }
+        b.resize(n);
+        return b;
+    }
+
+    //////////////////////////////////////////
+    /// \brief The first n coefficients of log(a). Needs a[0] = 1 and n <= p.
+    //////////////////////////////////////////
+    series log(const series& a, std::size_t n) const
+    {
+        assert(!a.empty() && a[0] == 1);
+        if (n == 0)
+            return {};
+
+        series da(std::min(a.size(), n) - 1);
+        for (std::size_t i = 0; i < da.size(); ++i)
+            da[i] = B_.mul(a[i + 1], static_cast<std::uint32_t>(i + 1));
+
+        series q = multiply(da, inverse(a, n), n - 1);
+        return integral(q);
+    }
+
+    //////////////////////////////////////////
+    /// \brief The first n coefficients of exp(a). Needs a[0] = 0 and n <= p.
+    //////////////////////////////////////////
+    series exp(const series& a, std::size_t n) const
+    {
+        assert(a.empty() || a[0] == 0);
+        series f{1};
+
+        // f <- f(1 - log(f) + a)
+        for (std::size_t len = 1; len < n;)
+        {
+            len *= 2;
+            series g = log(f, len);
+            for (std::size_t i = 0; i < len; ++i)
+                g[i] = B_.sub(i < a.size() ? a[i] : 0, g[i]);
+            g[0] = B_.add(g[0], 1);
+            f = multiply(f, g, len);
+        }
+        f.resize(n);
+        return f;
+    }
+
+private:
+    // below this, schoolbook multiplication is faster
+    static constexpr std::size_t naive_threshold = 32;
+
+    Barrett B_;
+    int max_log_{0};
+    std::uint32_t root_{1}; // of order 2^max_log_
+
+    std::uint32_t root_of_unity(std::size_t n, bool invert) const
+    {
+        std::uint32_t w = B_.pow(root_, max_length()/n);
+        return invert ? B_.pow(w, modulus() - 2) : w;
+    }
+
+    // q_0 + q_1 x + ... -> 0 + q_0 x + q_1 x^2/2 + ...
+    series integral(const series& q) const
+    {
+        auto inv = inverses_mod(static_cast<std::uint32_t>(q.size()), modulus());
+        series result(q.size() + 1, 0);
+        for (std::size_t i = 0; i < q.size(); ++i)
+            result[i + 1] = B_.mul(q[i], inv[i + 1]);
+        return result;
+    }
+};
+
+//////////////////////////////////////////
+/// \brief The first n coefficients of a*b modulo any m < 2^31, with three
+/// NTT primes combined with the chinese remainder theorem.
+///
+/// Every coefficient of a*b (before reducing mod m) must be smaller than the
+/// product of the primes, about 2^86, which holds if
+/// min(a.size(), b.size())*m^2 < 2^86. The sizes are limited to 2^23.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> multiply_mod(const std::vector<std::uint32_t>& a,
+                                               const std::vector<std::uint32_t>& b,
+                                               std::uint32_t m,
+                                               std::size_t n)
+{
+    static constexpr std::uint32_t p1 = 998244353;
+    static constexpr std::uint32_t p2 = 167772161;
+    static constexpr std::uint32_t p3 = 469762049;
+    static const PowerSeriesMod P1(p1), P2(p2), P3(p3);
+
+    assert(double(std::min(a.size(), b.size()))*m*m < double(p1)*p2*p3);
+
+    Barrett M(m);
+    std::vector<std::uint32_t> c(n, 0);
+    if (m == 1)
+        return c;
+
+    auto r1 = P1.multiply(a, b, n);
+    auto r2 = P2.multiply(a, b, n);
+    auto r3 = P3.multiply(a, b, n);
+
+    // Garner: x = r1 + p1*t2 + p1*p2*t3
+    const std::uint64_t p1p2 = std::uint64_t(p1)*p2;
+    const std::uint64_t inv_p1 = inverse_mod(p1, p2);
+    const std::uint64_t inv_p1p2 = inverse_mod(p1p2%p3, p3);
+    const std::uint64_t p1p2_mod_m = p1p2%m;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        std::uint64_t t2 = (r2[i] + p2 - r1[i]%p2)%p2*inv_p1%p2;
+        std::uint64_t x12 = r1[i] + p1*t2;
+        std::uint64_t t3 = (r3[i] + p3 - x12%p3)%p3*inv_p1p2%p3;
+        c[i] = M.add(M.reduce(x12), M.reduce(p1p2_mod_m*t3));
+    }
+    return c;
+}
+
+namespace detail
+{
+    // log of prod_{s in parts} 1/(1-x^s), or of prod (1+x^s) if distinct,
+    // up to x^N: sum_s sum_j (+-1)^(j+1) x^(sj)/j.
+    inline std::vector<std::uint32_t> euler_log(std::uint32_t N,
+                                                std::vector<std::uint32_t> parts,
+                                                bool distinct,
+                                                std::uint32_t p)
+    {
+        std::sort(parts.begin(), parts.end());
+        parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+
+        Barrett B(p);
+        auto inv = inverses_mod(N, p);
+        std::vector<std::uint32_t> L(N + 1, 0);
+        for (auto s : parts)
+        {
+            if (s == 0 || s > N)
+                continue;
+            for (std::uint32_t j = 1; std::uint64_t(s)*j <= N; ++j)
+            {
+                std::uint32_t term = (distinct && j%2 == 0) ? B.sub(0, inv[j]) : inv[j];
+                L[s*j] = B.add(L[s*j], term);
+            }
+        }
+        return L;
+    }
+
+    // coefficients of (x+lo)(x+lo+1)...(x+hi-1)
+    inline std::vector<std::uint32_t>
+    rising_factorial(const PowerSeriesMod& P, std::uint32_t lo, std::uint32_t hi)
+    {
+        if (hi - lo == 1)
+            return {lo%P.modulus(), 1};
+        std::uint32_t mid = lo + (hi - lo)/2;
+        return P.multiply(rising_factorial(P, lo, mid), rising_factorial(P, mid, hi));
+    }
+} // namespace detail
+
+//////////////////////////////////////////
+/// \brief partition_number(0), ..., partition_number(N) mod an NTT prime p,
+/// as the inverse of Euler's pentagonal series.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> partition_mod_table(std::uint32_t N,
+                                                      std::uint32_t p = 998244353)
+{
+    PowerSeriesMod P(p);
+    std::vector<std::uint32_t> E(N + 1, 0);
+    // prod (1-x^k) = sum_k (-1)^k x^(k(3k-1)/2), k = 0, 1, -1, 2, -2, ...
+    E[0] = 1;
+    for (std::uint64_t k = 1;; ++k)
+    {
+        std::uint32_t sign = (k%2 == 1) ? p - 1 : 1;
+        std::uint64_t a = k*(3*k - 1)/2;
+        std::uint64_t b = k*(3*k + 1)/2;
+        if (a > N)
+            break;
+        E[a] = sign;
+        if (b <= N)
+            E[b] = sign;
+    }
+    return P.inverse(E, N + 1);
+}
+
+//////////////////////////////////////////
+/// \brief The number of partitions of 0, ..., N with all parts in the given
+/// set (repetitions allowed), mod an NTT prime p > N.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t>
+partition_with_parts_mod_table(std::uint32_t N,
+                               const std::vector<std::uint32_t>& parts,
+                               std::uint32_t p = 998244353)
+{
+    PowerSeriesMod P(p);
+    return P.exp(detail::euler_log(N, parts, false, p), N + 1);
+}
+
+//////////////////////////////////////////
+/// \brief The number of partitions of 0, ..., N into distinct parts from the
+/// given set, mod an NTT prime p > N.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t>
+distinct_partition_with_parts_mod_table(std::uint32_t N,
+                                        const std::vector<std::uint32_t>& parts,
+                                        std::uint32_t p = 998244353)
+{
+    PowerSeriesMod P(p);
+    return P.exp(detail::euler_log(N, parts, true, p), N + 1);
+}
+
+//////////////////////////////////////////
+/// \brief The number of partitions of 0, ..., N into distinct parts, mod an
+/// NTT prime p > N.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> distinct_partition_mod_table(std::uint32_t N,
+                                                               std::uint32_t p = 998244353)
+{
+    std::vector<std::uint32_t> parts(N);
+    for (std::uint32_t i = 0; i < N; ++i)
+        parts[i] = i + 1;
+    return distinct_partition_with_parts_mod_table(N, parts, p);
+}
+
+//////////////////////////////////////////
+/// \brief The number of partitions of 0, ..., N into at most m parts (which
+/// is the same as into parts of size at most m), mod an NTT prime p > N.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t>
+partition_at_most_mod_table(std::uint32_t N, std::uint32_t m, std::uint32_t p = 998244353)
+{
+    std::vector<std::uint32_t> parts(std::min(N, m));
+    for (std::uint32_t i = 0; i < parts.size(); ++i)
+        parts[i] = i + 1;
+    return partition_with_parts_mod_table(N, parts, p);
+}
+
+//////////////////////////////////////////
+/// \brief The number of compositions (ordered partitions) of 0, ..., N with
+/// all parts in the given set, mod an NTT prime p.
+//////////////////////////////////////////
+inline std::vector<std::uint32_t>
+composition_with_parts_mod_table(std::uint32_t N,
+                                 const std::vector<std::uint32_t>& parts,
+                                 std::uint32_t p = 998244353)
+{
+    PowerSeriesMod P(p);
+    // 1/(1 - sum_s x^s)
+    std::vector<std::uint32_t> D(N + 1, 0);
+    D[0] = 1;
+    Barrett B(p);
+    for (auto s : parts)
+        if (s >= 1 && s <= N)
+            D[s] = B.sub(D[s], 1);
+    return P.inverse(D, N + 1);
+}
+
+//////////////////////////////////////////
+/// \brief Bell numbers B_0, ..., B_N mod an NTT prime p > N, from the
+/// exponential generating function exp(e^x - 1).
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> bell_mod_table(std::uint32_t N, std::uint32_t p = 998244353)
+{
+    assert(N < p);
+    PowerSeriesMod P(p);
+    BinomialMod F(N, p);
+    Barrett B(p);
+
+    std::vector<std::uint32_t> E(N + 1, 0);
+    for (std::uint32_t i = 1; i <= N; ++i)
+        E[i] = F.inverse_factorial(i);
+
+    auto result = P.exp(E, N + 1);
+    for (std::uint32_t i = 0; i <= N; ++i)
+        result[i] = B.mul(result[i], F.factorial(i));
+    return result;
+}
+
+//////////////////////////////////////////
+/// \brief Row n of the Stirling numbers of the second kind, S(n,0), ...,
+/// S(n,n), mod an NTT prime p > n, in O(n log n).
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> stirling_partition_row_mod(std::uint32_t n,
+                                                             std::uint32_t p = 998244353)
+{
+    assert(n < p);
+    PowerSeriesMod P(p);
+    BinomialMod F(n, p);
+    Barrett B(p);
+
+    // S(n,k) = sum_i i^n/i! * (-1)^(k-i)/(k-i)!
+    std::vector<std::uint32_t> a(n + 1), b(n + 1);
+    for (std::uint32_t i = 0; i <= n; ++i)
+    {
+        a[i] = B.mul(B.pow(i, n), F.inverse_factorial(i));
+        b[i] = (i%2 == 0) ? F.inverse_factorial(i) : B.sub(0, F.inverse_factorial(i));
+    }
+    return P.multiply(a, b, n + 1);
+}
+
+//////////////////////////////////////////
+/// \brief Row n of the (unsigned) Stirling numbers of the first kind, c(n,0),
+/// ..., c(n,n), mod an NTT prime p, as the coefficients of x(x+1)...(x+n-1).
+/// O(n log^2 n).
+//////////////////////////////////////////
+inline std::vector<std::uint32_t> stirling_cycle_row_mod(std::uint32_t n,
+                                                         std::uint32_t p = 998244353)
+{
+    if (n == 0)
+        return {1};
+    PowerSeriesMod P(p);
+    return detail::rising_factorial(P, 0, n);
+}
+
+} // namespace discreture
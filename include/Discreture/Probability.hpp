@@ -1,34 +1,221 @@
 #pragma once
 
 #include "Misc.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <ctime>
 #include <random>
+#include <unordered_set>
+
 namespace discreture
 {
 namespace random
 {
-    // You'll want to use something else, probably.
+    /**
+     *@brief splitmix64, only used to turn seeds into good initial states.
+     *@param x is the state, which gets advanced.
+     */
+    inline std::uint64_t splitmix64(std::uint64_t& x)
+    {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
 
     /**
-     *@brief Just a helper function to get the default random engine
+     *@brief xoshiro256** by Blackman and Vigna. A fast generator with a period
+     *of 2^256-1 and 256 bits of state, which satisfies
+     *UniformRandomBitGenerator, so it can be used with every std distribution
+     *and every random(engine) function of discreture.
+     *
+     *Streams: xoshiro256ss(seed, i) for different pairs (seed, i) are
+     *different generators that depend only on (seed, i), so each thread (or
+     *each chunk of work) can get its own and results are reproducible no
+     *matter how work is scheduled.
+     *For streams that are guaranteed not to overlap, use split(), which hands
+     *out consecutive blocks of 2^128 numbers.
      */
-    inline std::default_random_engine& random_engine()
+    class xoshiro256ss
     {
-        using RE = std::default_random_engine;
-        using rt = RE::result_type;
-        static std::default_random_engine eng(static_cast<rt>(time(nullptr)));
+    public:
+        using result_type = std::uint64_t;
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return ~result_type(0); }
+
+        explicit xoshiro256ss(std::uint64_t seed = 0x853C49E6748FEA9BULL)
+        {
+            this->seed(seed);
+        }
+
+        xoshiro256ss(std::uint64_t seed, std::uint64_t stream)
+        {
+            this->seed(seed, stream);
+        }
+
+        void seed(std::uint64_t seed)
+        {
+            for (auto& x : s_)
+                x = splitmix64(seed);
+        }
+
+        void seed(std::uint64_t seed, std::uint64_t stream)
+        {
+            // s_[0] determines seed, and then s_[1] determines stream, so
+            // different pairs never give the same state.
+            s_[0] = splitmix64(seed);
+            std::uint64_t x = stream ^ s_[0];
+            for (int i = 1; i < 4; ++i)
+                s_[i] = splitmix64(x);
+        }
+
+        result_type operator()()
+        {
+            const std::uint64_t result = rotl(s_[1]*5, 7)*9;
+            const std::uint64_t t = s_[1] << 17;
+
+            s_[2] ^= s_[0];
+            s_[3] ^= s_[1];
+            s_[1] ^= s_[2];
+            s_[0] ^= s_[3];
+
+            s_[2] ^= t;
+            s_[3] = rotl(s_[3], 45);
+
+            return result;
+        }
+
+        void discard(unsigned long long z)
+        {
+            for (; z != 0; --z)
+                (*this)();
+        }
+
+        /**
+         *@brief Equivalent to 2^128 calls to operator().
+         */
+        void jump()
+        {
+            static constexpr std::uint64_t J[] = {0x180EC6D33CFD0ABAULL,
+                                                  0xD5A61266F0C9392CULL,
+                                                  0xA9582618E03FC9AAULL,
+                                                  0x39ABDC4529B1661CULL};
+            apply_jump(J);
+        }
+
+        /**
+         *@brief Equivalent to 2^192 calls to operator().
+         */
+        void long_jump()
+        {
+            static constexpr std::uint64_t J[] = {0x76E15D3EFEFDCBBFULL,
+                                                  0xC5004E441C522FB3ULL,
+                                                  0x77710069854EE241ULL,
+                                                  0x39109BB02ACBE635ULL};
+            apply_jump(J);
+        }
+
+        /**
+         *@brief Returns a copy of this generator and then jumps this one ahead,
+         *so the returned generator can produce 2^128 numbers before reaching
+         *anything this one will produce.
+         */
+        xoshiro256ss split()
+        {
+            xoshiro256ss result = *this;
+            jump();
+            return result;
+        }
+
+        friend bool operator==(const xoshiro256ss& a, const xoshiro256ss& b)
+        {
+            return a.s_ == b.s_;
+        }
+
+        friend bool operator!=(const xoshiro256ss& a, const xoshiro256ss& b)
+        {
+            return !(a == b);
+        }
+
+    private:
+        std::array<std::uint64_t, 4> s_;
+
+        static std::uint64_t rotl(std::uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        void apply_jump(const std::uint64_t (&J)[4])
+        {
+            std::array<std::uint64_t, 4> t{};
+            for (auto j : J)
+            {
+                for (int b = 0; b < 64; ++b)
+                {
+                    if (j & (std::uint64_t(1) << b))
+                    {
+                        for (int i = 0; i < 4; ++i)
+                            t[i] ^= s_[i];
+                    }
+                    (*this)();
+                }
+            }
+            s_ = t;
+        }
+    };
+
+    using default_engine = xoshiro256ss;
+
+    namespace detail
+    {
+        inline std::uint64_t fresh_seed()
+        {
+            static std::atomic<std::uint64_t> counter{0};
+            std::random_device rd;
+            std::uint64_t seed = (std::uint64_t(rd()) << 32) ^ rd();
+            seed ^= std::uint64_t(std::time(nullptr));
+            return seed ^ (++counter*0x9E3779B97F4A7C15ULL);
+        }
+    } // namespace detail
+
+    /**
+     *@brief The random engine of the calling thread. Every thread has its own,
+     *so using it never races and never contends. It starts with a
+     *nondeterministic seed; use seed_random_engine to make it reproducible.
+     */
+    inline default_engine& random_engine()
+    {
+        thread_local default_engine eng(detail::fresh_seed());
         return eng;
     }
 
+    /**
+     *@brief Reseeds the calling thread's engine (other threads are not
+     *affected).
+     */
+    inline void seed_random_engine(std::uint64_t seed)
+    {
+        random_engine().seed(seed);
+    }
+
     /**
      *@brief Returns true with probability p and false with probability 1-p
      *@return true or false according to probability p, which must be a number
      *between 0 and 1.
      */
-    inline bool probability_of_true(double p)
+    template <class Engine>
+    bool probability_of_true(double p, Engine& engine)
     {
         std::bernoulli_distribution d(p);
-        return d(random_engine());
+        return d(engine);
+    }
+
+    inline bool probability_of_true(double p)
+    {
+        return probability_of_true(p, random_engine());
     }
 
     /**
@@ -36,12 +223,17 @@ namespace random
      *@return A random integer in the range [from,upto), with uniform
      *probability distribution
      */
+    template <class IntType, class Engine>
+    IntType random_int(IntType from, IntType upto, Engine& engine)
+    {
+        std::uniform_int_distribution<IntType> d(from, upto - 1);
+        return d(engine);
+    }
+
     template <class IntType = int>
     IntType random_int(IntType from, IntType upto)
     {
-        static std::uniform_int_distribution<IntType> d{};
-        using parm_t = typename decltype(d)::param_type;
-        return d(random_engine(), parm_t{from, --upto});
+        return random_int(from, upto, random_engine());
     }
 
     /**
@@ -49,12 +241,94 @@ namespace random
      *@return A random float number in the range [from,upto), with uniform
      *probability distribution
      */
+    template <class FloatType, class Engine>
+    FloatType random_real(FloatType from, FloatType upto, Engine& engine)
+    {
+        std::uniform_real_distribution<FloatType> d(from, upto);
+        return d(engine);
+    }
+
     template <class FloatType = double>
     FloatType random_real(FloatType from, FloatType upto)
     {
-        static std::uniform_real_distribution<> d{};
-        using parm_t = typename decltype(d)::param_type;
-        return d(random_engine(), parm_t{from, upto});
+        return random_real(from, upto, random_engine());
+    }
+
+    /**
+     *@brief Fills [first, last) with random integers in [from,upto). Much
+     *cheaper than calling random_int once per element.
+     */
+    template <class OutputIt, class IntType, class Engine>
+    void fill_random_int(OutputIt first,
+                         OutputIt last,
+                         IntType from,
+                         IntType upto,
+                         Engine& engine)
+    {
+        std::uniform_int_distribution<IntType> d(from, upto - 1);
+        for (; first != last; ++first)
+            *first = d(engine);
+    }
+
+    template <class OutputIt, class IntType>
+    void fill_random_int(OutputIt first, OutputIt last, IntType from, IntType upto)
+    {
+        fill_random_int(first, last, from, upto, random_engine());
+    }
+
+    /**
+     *@brief Fills [first, last) with random reals in [from,upto).
+     */
+    template <class OutputIt, class FloatType, class Engine>
+    void fill_random_real(OutputIt first,
+                          OutputIt last,
+                          FloatType from,
+                          FloatType upto,
+                          Engine& engine)
+    {
+        std::uniform_real_distribution<FloatType> d(from, upto);
+        for (; first != last; ++first)
+            *first = d(engine);
+    }
+
+    template <class OutputIt, class FloatType>
+    void fill_random_real(OutputIt first,
+                          OutputIt last,
+                          FloatType from,
+                          FloatType upto)
+    {
+        fill_random_real(first, last, from, upto, random_engine());
+    }
+
+    /**
+     *@brief Floyd's algorithm: a uniformly random k-subset of {0,1,...,n-1}
+     *@return The subset, sorted in increasing order, in a container of type
+     *Container. Takes O(k) random numbers and O(k log k) time, no matter how
+     *large n is.
+     */
+    template <class Container, class IntType, class Engine>
+    Container random_sorted_subset(IntType n, IntType k, Engine& engine)
+    {
+        Container result;
+        std::unordered_set<IntType> chosen;
+        chosen.reserve(k);
+
+        for (IntType j = n - k; j < n; ++j)
+        {
+            std::uniform_int_distribution<IntType> d(0, j);
+            IntType t = d(engine);
+
+            // j is larger than everything chosen so far
+            if (!chosen.insert(t).second)
+            {
+                t = j;
+                chosen.insert(t);
+            }
+            result.push_back(t);
+        }
+
+        std::sort(result.begin(), result.end());
+        return result;
     }
 
 } // namespace random
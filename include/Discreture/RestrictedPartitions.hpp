@@ -0,0 +1,298 @@
+#pragma once
+
+#include "detail/TriangularTable.hpp"
+#include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
+#include <memory>
+#include <vector>
+
+namespace discreture
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Partitions of n whose parts are all in a given set, and optionally
+/// all different, in reverse lexicographic order.
+///
+/// A table W(i,m) of the number of such partitions of m using only the i
+/// smallest allowed parts is computed on construction (in O(n*s) time and
+/// memory, where s is the number of allowed parts). It gives size(), and
+/// lets the successor and for_each skip every choice that can't be
+/// completed, so the cost is proportional to the number of restricted
+/// partitions, not to p(n).
+///
+/// Counts that don't fit in a size_type are saturated to its maximum (so
+/// size() is exact only while it fits, e.g. n < 770 for distinct parts and
+/// n < 406 for unrestricted ones), but the successor stays correct. Since
+/// the table has (s+1)*(n+1) entries, n is meant to be at most a few
+/// thousand; for counts of huge n (modulo a prime), see PowerSeries.hpp.
+///
+/// # Example:
+///
+///     auto X = distinct_partitions(8);
+///     for (auto&& x : X)
+///         cout << x << ' ';
+///
+/// Prints out:
+///
+///     [ 8 ] [ 7 1 ] [ 6 2 ] [ 5 3 ] [ 5 2 1 ] [ 4 3 1 ]
+////////////////////////////////////////////////////////////
+template <class IntType = int, class RAContainerInt = std::vector<IntType>>
+class RestrictedPartitions
+{
+public:
+    static_assert(std::is_integral<IntType>::value,
+                  "Template parameter IntType must be integral");
+    using value_type = RAContainerInt;
+    using partition = value_type;
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+    class iterator;
+    using const_iterator = iterator;
+
+private:
+    struct table;
+
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param n is an integer >= 0
+    /// \param allowed_parts are the sizes the parts can have (in any order;
+    /// those that are not between 1 and n are ignored).
+    /// \param distinct says if the parts must all be different.
+    ////////////////////////////////////////////////////////////
+    RestrictedPartitions(IntType n, std::vector<IntType> allowed_parts, bool distinct = false)
+        : n_(n), table_(std::make_shared<table>(n, std::move(allowed_parts), distinct))
+    {}
+
+    ////////////////////////////////////////////////////////////
+    /// \brief The number of restricted partitions of n (or the largest
+    /// size_type if it doesn't fit).
+    ////////////////////////////////////////////////////////////
+    size_type size() const { return table_->count(table_->num_parts(), n_); }
+
+    IntType get_n() const { return n_; }
+
+    bool distinct() const { return table_->distinct; }
+
+    const std::vector<IntType>& allowed_parts() const { return table_->parts; }
+
+    iterator begin() const { return iterator(n_, table_); }
+
+    const iterator end() const { return iterator::make_invalid_with_id(size()); }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Calls f(x) for every restricted partition x, in the same order
+    /// as iterating. Faster than iterating.
+    ////////////////////////////////////////////////////////////
+    template <class Func>
+    void for_each(Func f) const
+    {
+        partition x;
+        for_each(f, x, table_->num_parts(), n_);
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forward iterator class.
+    ////////////////////////////////////////////////////////////
+    class iterator
+        : public boost::iterator_facade<iterator, const partition&, boost::forward_traversal_tag>
+    {
+    public:
+        iterator() = default;
+
+        iterator(IntType n, std::shared_ptr<const table> T)
+            : table_(std::move(T))
+        {
+            table_->fill(data_, index_, table_->num_parts(), n);
+        }
+
+        inline size_type ID() const { return ID_; }
+
+        static const iterator make_invalid_with_id(size_type id)
+        {
+            iterator it;
+            it.ID_ = id;
+            return it;
+        }
+
+    private:
+        void increment()
+        {
+            ++ID_;
+
+            // Remove parts from the end until one can be replaced by a
+            // smaller allowed part.
+            IntType remainder = 0;
+            while (!data_.empty())
+            {
+                remainder += data_.back();
+                std::size_t bound = index_.back();
+                data_.pop_back();
+                index_.pop_back();
+                if (table_->fill(data_, index_, bound, remainder))
+                    return;
+            }
+        }
+
+        const partition& dereference() const { return data_; }
+
+        bool equal(const iterator& it) const { return it.ID() == ID(); }
+
+    private:
+        size_type ID_{0};
+        partition data_;
+        std::vector<std::size_t> index_; // of each part in allowed_parts
+        std::shared_ptr<const table> table_;
+
+        friend class boost::iterator_core_access;
+    }; // end class iterator
+
+private:
+    // The allowed parts (sorted), and W(i,m) for 0 <= i <= s, 0 <= m <= n,
+    // saturated, so W(i,m) > 0 exactly when m can be reached.
+    struct table
+    {
+        std::vector<IntType> parts;
+        bool distinct;
+        IntType n;
+        std::vector<size_type> W;
+
+        table(IntType N, std::vector<IntType> allowed, bool dist)
+            : parts(std::move(allowed)), distinct(dist), n(std::max<IntType>(N, 0))
+        {
+            std::sort(parts.begin(), parts.end());
+            parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+            parts.erase(std::remove_if(parts.begin(),
+                                       parts.end(),
+                                       [this](IntType a) { return a < 1 || a > n; }),
+                        parts.end());
+
+            const std::size_t s = parts.size();
+            W.assign((s + 1)*(n + 1), 0);
+            W[0] = 1;
+            for (std::size_t i = 1; i <= s; ++i)
+            {
+                IntType a = parts[i - 1];
+                // with or without a copy of a; the rest of the parts can use
+                // a again only if repetitions are allowed
+                std::size_t rest = distinct ? i - 1 : i;
+                for (IntType m = 0; m <= n; ++m)
+                    W[i*(n + 1) + m] = detail::saturating_add(
+                      count(i - 1, m), m >= a ? W[rest*(n + 1) + m - a] : 0);
+            }
+        }
+
+        std::size_t num_parts() const { return parts.size(); }
+
+        // partitions of m with parts among the i smallest allowed ones
+        size_type count(std::size_t i, IntType m) const
+        {
+            return (m < 0 || m > n) ? 0 : W[i*(n + 1) + m];
+        }
+
+        // if there is any such partition (even if count saturated)
+        bool reachable(std::size_t i, IntType m) const { return count(i, m) > 0; }
+
+        // How many of the allowed parts can follow a part with index j.
+        std::size_t next_bound(std::size_t j) const { return distinct ? j : j + 1; }
+
+        // The largest allowed part with index < bound with which a partition
+        // of m can be completed, or bound if there is none.
+        std::size_t largest_feasible(std::size_t bound, IntType m) const
+        {
+            auto j = static_cast<std::size_t>(
+              std::upper_bound(parts.begin(), parts.begin() + bound, m) - parts.begin());
+            while (j > 0)
+            {
+                --j;
+                if (reachable(next_bound(j), m - parts[j]))
+                    return j;
+            }
+            return bound;
+        }
+
+        // Appends the largest (in lex order) completion of x that adds up to
+        // m with parts of index < bound, if there is one.
+        bool fill(partition& x, std::vector<std::size_t>& index, std::size_t bound, IntType m) const
+        {
+            // only the first choice can fail: the later ones are feasible
+            while (m > 0)
+            {
+                std::size_t j = largest_feasible(bound, m);
+                if (j == bound)
+                    return false;
+                x.push_back(parts[j]);
+                index.push_back(j);
+                m -= parts[j];
+                bound = next_bound(j);
+            }
+            return true;
+        }
+    };
+
+    IntType n_;
+    std::shared_ptr<const table> table_;
+
+    template <class Func>
+    void for_each(Func& f, partition& x, std::size_t bound, IntType m) const
+    {
+        if (m == 0)
+        {
+            f(static_cast<const partition&>(x));
+            return;
+        }
+
+        const auto& T = *table_;
+        auto j = static_cast<std::size_t>(
+          std::upper_bound(T.parts.begin(), T.parts.begin() + bound, m) - T.parts.begin());
+        while (j > 0)
+        {
+            --j;
+            IntType rest = m - T.parts[j];
+            if (!T.reachable(T.next_bound(j), rest))
+                continue;
+            x.push_back(T.parts[j]);
+            for_each(f, x, T.next_bound(j), rest);
+            x.pop_back();
+        }
+    }
+
+}; // end class RestrictedPartitions
+
+////////////////////////////////////////////////////////////
+/// \brief Partitions of n into distinct parts.
+////////////////////////////////////////////////////////////
+inline RestrictedPartitions<int> distinct_partitions(int n)
+{
+    std::vector<int> parts(std::max(n, 0));
+    for (int i = 0; i < n; ++i)
+        parts[i] = i + 1;
+    return RestrictedPartitions<int>(n, parts, true);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Partitions of n with all parts <= max_part (equivalently, by
+/// conjugation, with at most max_part parts).
+////////////////////////////////////////////////////////////
+inline RestrictedPartitions<int> partitions_with_max_part(int n, int max_part)
+{
+    std::vector<int> parts(std::max(std::min(n, max_part), 0));
+    for (int i = 0; i < static_cast<int>(parts.size()); ++i)
+        parts[i] = i + 1;
+    return RestrictedPartitions<int>(n, parts);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Partitions of n with all parts in allowed_parts.
+////////////////////////////////////////////////////////////
+inline RestrictedPartitions<int> partitions_with_parts(int n,
+                                                       const std::vector<int>& allowed_parts,
+                                                       bool distinct = false)
+{
+    return RestrictedPartitions<int>(n, allowed_parts, distinct);
+}
+
+using restricted_partitions = RestrictedPartitions<int>;
+
+} // namespace discreture
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "Probability.hpp"
+#include "TemplateHelpers.hpp"
+
+namespace discreture
+{
+
+namespace detail
+{
+    //////////////////////////////////////////
+    /// \brief Iterator over a subsequence of a random access container, given
+    /// by positions pos(0) < pos(1) < ... < pos(m-1).
+    ///
+    /// It just advances the underlying iterator by pos(i+1)-pos(i), so for
+    /// discreture families it reuses a single buffer and steps or unranks
+    /// (whatever is cheaper) to get to the next element.
+    //////////////////////////////////////////
+    template <class BaseIterator, class Positions>
+    class subsequence_iterator
+        : public boost::iterator_facade<
+            subsequence_iterator<BaseIterator, Positions>,
+            typename std::iterator_traits<BaseIterator>::value_type,
+            boost::random_access_traversal_tag,
+            typename std::iterator_traits<BaseIterator>::reference>
+    {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using reference = typename std::iterator_traits<BaseIterator>::reference;
+
+        subsequence_iterator() = default;
+
+        subsequence_iterator(BaseIterator first,
+                             const Positions* positions,
+                             difference_type index)
+            : it_(first), positions_(positions), index_(index)
+        {
+            if (positions_->size() > 0)
+                it_ += (*positions_)(clamped(index_));
+        }
+
+        difference_type index() const { return index_; }
+
+    private:
+        BaseIterator it_{};
+        const Positions* positions_{nullptr};
+        difference_type index_{0};
+
+        // The underlying iterator never goes past the last chosen element, so
+        // that it never has to represent anything out of range.
+        difference_type clamped(difference_type i) const
+        {
+            difference_type last = positions_->size() - 1;
+            return std::max<difference_type>(0, std::min(i, last));
+        }
+
+        void increment() { advance(1); }
+
+        void decrement() { advance(-1); }
+
+        void advance(difference_type n)
+        {
+            if (positions_->size() > 0)
+            {
+                auto from = (*positions_)(clamped(index_));
+                auto to = (*positions_)(clamped(index_ + n));
+                it_ += to - from;
+            }
+            index_ += n;
+        }
+
+        reference dereference() const { return *it_; }
+
+        bool equal(const subsequence_iterator& other) const
+        {
+            return index_ == other.index_;
+        }
+
+        difference_type distance_to(const subsequence_iterator& other) const
+        {
+            return other.index_ - index_;
+        }
+
+        friend class boost::iterator_core_access;
+    };
+
+    // pos(i) = offset + i*step
+    class strided_positions
+    {
+    public:
+        using difference_type = std::ptrdiff_t;
+
+        strided_positions(difference_type total,
+                          difference_type step,
+                          difference_type offset)
+            : step_(step), offset_(offset)
+        {
+            if (offset < total)
+                size_ = (total - offset + step - 1)/step;
+        }
+
+        difference_type operator()(difference_type i) const
+        {
+            return offset_ + i*step_;
+        }
+
+        difference_type size() const { return size_; }
+
+    private:
+        difference_type step_;
+        difference_type offset_;
+        difference_type size_{0};
+    };
+
+    // pos(i) = i-th smallest of a fixed set of indices
+    class sampled_positions
+    {
+    public:
+        using difference_type = std::ptrdiff_t;
+
+        sampled_positions(std::vector<difference_type> indices)
+            : indices_(std::move(indices))
+        {}
+
+        difference_type operator()(difference_type i) const
+        {
+            return indices_[i];
+        }
+
+        difference_type size() const { return indices_.size(); }
+
+        const std::vector<difference_type>& indices() const { return indices_; }
+
+    private:
+        std::vector<difference_type> indices_;
+    };
+
+} // namespace detail
+
+//////////////////////////////////////////
+/// \brief Returns m distinct integers of [0,n), chosen uniformly at random
+/// (every subset of size m is equally likely), in increasing order.
+///
+/// Uses Floyd's algorithm when m is small compared to n, and selection
+/// sampling (Knuth's algorithm S) otherwise, so it always takes O(m) memory
+/// and O(min(n, m log m)) time.
+//////////////////////////////////////////
+template <class Engine>
+std::vector<std::ptrdiff_t>
+random_sorted_indices(std::ptrdiff_t n, std::ptrdiff_t m, Engine& engine)
+{
+    using difference_type = std::ptrdiff_t;
+
+    m = std::max<difference_type>(0, std::min(m, n));
+    std::vector<difference_type> result;
+    result.reserve(m);
+
+    if (m > n/8)
+    {
+        // Algorithm S: pick i with probability (still needed)/(still left).
+        difference_type needed = m;
+        for (difference_type i = 0; i < n && needed > 0; ++i)
+        {
+            std::uniform_int_distribution<difference_type> d(0, n - i - 1);
+            if (d(engine) < needed)
+            {
+                result.push_back(i);
+                --needed;
+            }
+        }
+        return result;
+    }
+
+    // Floyd's algorithm
+    std::unordered_set<difference_type> chosen;
+    chosen.reserve(2*m);
+    for (difference_type j = n - m; j < n; ++j)
+    {
+        std::uniform_int_distribution<difference_type> d(0, j);
+        auto t = d(engine);
+        if (!chosen.insert(t).second)
+            chosen.insert(j);
+    }
+
+    result.assign(chosen.begin(), chosen.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+//////////////////////////////////////////
+/// \brief A view of every step-th element of a container, starting with
+/// element number offset.
+///
+/// Iterators are random access, so this can be fed to parallel_for_each. For
+/// discreture families, iteration reuses the underlying iterator's buffer
+/// instead of calling operator[] (which allocates).
+///
+/// # Example:
+///
+///     for (auto& x : strided(combinations(40,20), 1000))
+///         do_something(x); // every 1000-th combination
+//////////////////////////////////////////
+template <class Container>
+class Strided
+{
+public:
+    using Cont_t = std::remove_cv_t<std::remove_reference_t<Container>>;
+    using value_type = typename Cont_t::value_type;
+    using difference_type = std::ptrdiff_t;
+    using size_type = std::ptrdiff_t;
+
+    using iterator =
+      detail::subsequence_iterator<typename Cont_t::const_iterator,
+                                   detail::strided_positions>;
+    using const_iterator = iterator;
+
+    Strided(Container&& C, difference_type step, difference_type offset = 0)
+        : original_(std::forward<Container>(C))
+        , positions_(original_.size(),
+                     std::max<difference_type>(1, step),
+                     std::max<difference_type>(0, offset))
+    {}
+
+    iterator begin() const { return iterator(original_.begin(), &positions_, 0); }
+    iterator end() const { return iterator(original_.begin(), &positions_, size()); }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_type size() const { return positions_.size(); }
+
+private:
+    add_const_to_value_t<Container> original_;
+    detail::strided_positions positions_;
+};
+
+//////////////////////////////////////////
+/// \brief A view of m distinct elements of a container chosen uniformly at
+/// random, without repeats, visited in the container's order.
+///
+/// The chosen indices depend only on (container size, m, seed), so the same
+/// seed gives the same sample on every run and on any number of threads.
+/// Iterators are random access, so the sample can be split with
+/// parallel_for_each and every thread gets a disjoint, reproducible part.
+///
+/// # Example:
+///
+///     // 1% sample of all 20-subsets of a 40-set.
+///     auto X = combinations(40, 20);
+///     for (auto& x : sample(X, X.size()/100, 12345))
+///         do_something(x);
+//////////////////////////////////////////
+template <class Container>
+class Sampled
+{
+public:
+    using Cont_t = std::remove_cv_t<std::remove_reference_t<Container>>;
+    using value_type = typename Cont_t::value_type;
+    using difference_type = std::ptrdiff_t;
+    using size_type = std::ptrdiff_t;
+
+    using iterator =
+      detail::subsequence_iterator<typename Cont_t::const_iterator,
+                                   detail::sampled_positions>;
+    using const_iterator = iterator;
+
+    template <class Engine>
+    Sampled(Container&& C, difference_type m, Engine& engine)
+        : original_(std::forward<Container>(C))
+        , positions_(random_sorted_indices(original_.size(), m, engine))
+    {}
+
+    iterator begin() const { return iterator(original_.begin(), &positions_, 0); }
+    iterator end() const { return iterator(original_.begin(), &positions_, size()); }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_type size() const { return positions_.size(); }
+
+    //////////////////////////////////////////
+    /// \brief The (sorted) indices of the chosen elements.
+    //////////////////////////////////////////
+    const std::vector<difference_type>& indices() const
+    {
+        return positions_.indices();
+    }
+
+private:
+    add_const_to_value_t<Container> original_;
+    detail::sampled_positions positions_;
+};
+
+// Utility functions for C++14 and below, like make_shared.
+template <class Container>
+auto strided(Container&& C, std::ptrdiff_t step, std::ptrdiff_t offset = 0)
+{
+    return Strided<Container>{std::forward<Container>(C), step, offset};
+}
+
+template <class Container>
+auto sample(Container&& C, std::ptrdiff_t m, std::uint64_t seed)
+{
+    random::xoshiro256ss engine(seed);
+    return Sampled<Container>{std::forward<Container>(C), m, engine};
+}
+
+} // namespace discreture
@@ -1,6 +1,7 @@
 #pragma once
 #include "Misc.hpp"
 #include "VectorHelpers.hpp"
+#include "detail/TriangularTable.hpp"
 #include <iostream>
 #include <vector>
 namespace discreture
@@ -55,6 +56,7 @@ inline BigIntType partition_number(llint n);
 /// \param n is a (small) nonnegative integer
 /// \param k <= n is a (small) nonnegative integer
 /// \return P_{n,k}
+/// (or std::numeric_limits<llint>::max() if it doesn't fit in an llint)
 //////////////////////////////
 template <class BigIntType = llint>
 inline BigIntType partition_number(llint n, llint k);
@@ -64,6 +66,7 @@ inline BigIntType partition_number(llint n, llint k);
 /// \param n is a (small) nonnegative integer
 /// \param k <= n is a (small) nonnegative integer
 /// \return The stirling number of the first kind S(n,k)
+/// (or std::numeric_limits<llint>::max() if it doesn't fit in an llint)
 //////////////////////////////
 template <class BigIntType = llint>
 inline BigIntType stirling_cycle_number(llint n, llint k);
@@ -73,6 +76,7 @@ inline BigIntType stirling_cycle_number(llint n, llint k);
 /// \param n is a (small) nonnegative integer
 /// \param k <= n is a (small) nonnegative integer
 /// \return The stirling number of the second kind S_{n,k}
+/// (or std::numeric_limits<llint>::max() if it doesn't fit in an llint)
 //////////////////////////////
 template <class BigIntType = llint>
 inline BigIntType stirling_partition_number(llint n, llint k);
@@ -254,18 +258,18 @@ inline BigIntType partition_number(llint n)
     return P[n];
 }
 
+// The largest first rows that can be computed at compile time without
+// overflowing an llint (for partitions, enough for typical sizes).
+namespace detail
+{
+    constexpr std::size_t partition_prefix_rows = 64;
+    constexpr std::size_t stirling_cycle_prefix_rows = 21;
+    constexpr std::size_t stirling_partition_prefix_rows = 26;
+} // namespace detail
+
 template <class BigIntType>
 inline BigIntType partition_number(llint n, llint k)
 {
-    static std::vector<std::vector<llint>> PNK = {{1},
-                                                  {0, 1},
-                                                  {0, 1, 1},
-                                                  {0, 1, 1, 1},
-                                                  {0, 1, 2, 1, 1},
-                                                  {0, 1, 2, 2, 1, 1}};
-
-    llint oldsize = PNK.size();
-
     if (k <= 0 || n <= 0)
         return n == 0 && k == 0;
 
@@ -275,82 +279,28 @@ inline BigIntType partition_number(llint n, llint k)
     if (k == n || k == 1)
         return 1;
 
-    if (n < oldsize)
-        return PNK[n][k];
-
-    for (llint m = oldsize; m <= n; ++m)
-    {
-        PNK.emplace_back(m + 1, 0);
-        for (llint l = 1; l <= m; ++l)
-        {
-            llint left = 0;
-            if (m - l >= l)
-                left = PNK[m - l][l];
-
-            PNK[m][l] = left + PNK[m - 1][l - 1];
-        }
-    }
-
-    return PNK[n][k];
+    return detail::triangle_lookup<detail::partition_rule,
+                                   detail::partition_prefix_rows>(n, k);
 }
 
 template <class BigIntType>
 inline BigIntType stirling_cycle_number(llint n, llint k)
 {
-    static std::vector<std::vector<llint>> S1 = {{1},
-                                                 {0, 1},
-                                                 {0, 1, 1},
-                                                 {0, 2, 3, 1},
-                                                 {0, 6, 11, 6, 1}};
-
     if (k > n || k < 0)
         return 0;
 
-    llint oldsize = S1.size();
-    if (n < oldsize)
-        return S1[n][k];
-
-    for (llint m = oldsize; m <= n; ++m)
-    {
-        S1.emplace_back(m + 1, 0);
-        for (llint l = 1; l <= m; ++l)
-        {
-            llint left = 0;
-            if (l < m)
-                left = (m - 1)*S1[m - 1][l];
-            S1[m][l] = left + S1[m - 1][l - 1];
-        }
-    }
-
-    return S1[n][k];
+    return detail::triangle_lookup<detail::stirling_cycle_rule,
+                                   detail::stirling_cycle_prefix_rows>(n, k);
 }
 
 template <class BigIntType>
 inline BigIntType stirling_partition_number(llint n, llint k)
 {
-    static std::vector<std::vector<llint>> S2 = {{1},
-                                                 {0, 1},
-                                                 {0, 1, 1},
-                                                 {0, 1, 3, 1},
-                                                 {0, 1, 7, 6, 1}};
-
-    llint oldsize = S2.size();
-    if (n < oldsize)
-        return S2[n][k];
-
-    for (llint m = oldsize; m <= n; ++m)
-    {
-        S2.emplace_back(m + 1, 0);
-        for (llint l = 1; l <= m; ++l)
-        {
-            llint left = 0;
-            if (l < m)
-                left = l*S2[m - 1][l];
-            S2[m][l] = left + S2[m - 1][l - 1];
-        }
-    }
+    if (k > n || k < 0)
+        return 0;
 
-    return S2[n][k];
+    return detail::triangle_lookup<detail::stirling_partition_rule,
+                                   detail::stirling_partition_prefix_rows>(n, k);
 }
 
 } // namespace discreture
@@ -4,6 +4,7 @@
 
 #include "ArithmeticProgression.hpp"
 #include "Misc.hpp"
+#include "Probability.hpp"
 #include "Partitions.hpp"
 #include "Sequences.hpp"
 #include "VectorHelpers.hpp"
@@ -157,6 +158,46 @@ public:
 
     IntType get_n() const { return n_; }
 
+    ////////////////////////////////////////////////////////////
+    /// \brief A uniformly random set partition (with the allowed number of
+    /// parts), with blocks in the same order as the iterator uses.
+    ///
+    /// If any number of parts is allowed, uses Stam's method: throw each
+    /// element into one of M urns, with M chosen with probability
+    /// M^n/(M! e B_n). This needs no tables, so it works for any n.
+    /// Otherwise uses the recurrence S(n,k) = kS(n-1,k) + S(n-1,k-1) to decide,
+    /// for each element, whether it starts a new block or joins one of the
+    /// previous ones, which needs no rejections. When the Stirling numbers
+    /// don't fit in an llint, the recurrence is computed with logarithms.
+    ///
+    /// \param engine is any uniform random bit generator.
+    ////////////////////////////////////////////////////////////
+    template <class Engine>
+    set_partition random(Engine& engine) const
+    {
+        std::vector<IntType> block_of(n_);
+
+        IntType num_blocks = (min_num_parts_ <= 1 && max_num_parts_ >= n_)
+          ? random_blocks_stam(block_of, engine)
+          : random_blocks_stirling(block_of, engine);
+
+        set_partition result(num_blocks);
+        for (IntType i = 0; i < n_; ++i)
+            result[block_of[i]].push_back(i);
+
+        std::sort(result.begin(),
+                  result.end(),
+                  [](const number_partition& a, const number_partition& b) {
+                      if (a.size() != b.size())
+                          return a.size() > b.size();
+                      return a.front() < b.front();
+                  });
+
+        return result;
+    }
+
+    set_partition random() const { return random(random::random_engine()); }
+
     iterator begin() const { return iterator(n_, max_num_parts_); }
 
     const iterator end() const
@@ -226,11 +267,102 @@ private:
         size_type toReturn = 0;
 
         for (IntType k = minnumparts; k <= maxnumparts; ++k)
-            toReturn += stirling_partition_number(n, k);
+            toReturn = detail::saturating_add(toReturn, stirling_partition_number(n, k));
 
         return toReturn;
     }
 
+    // Fills block_of with the block each element belongs to (blocks are
+    // numbered 0,1,... in order of appearance). Returns the number of blocks.
+    template <class Engine>
+    IntType random_blocks_stam(std::vector<IntType>& block_of,
+                               Engine& engine) const
+    {
+        if (n_ == 0)
+            return 0;
+
+        // log of m^n/m!, up to the point where it becomes negligible
+        std::vector<double> log_weights;
+        double max_log_weight = 0.0;
+        for (IntType m = 1;; ++m)
+        {
+            double lw = n_*std::log(double(m)) - std::lgamma(m + 1.0);
+            log_weights.push_back(lw);
+            max_log_weight = std::max(max_log_weight, lw);
+            if (lw < max_log_weight - 50.0)
+                break;
+        }
+
+        std::vector<double> weights;
+        weights.reserve(log_weights.size());
+        for (auto lw : log_weights)
+            weights.push_back(std::exp(lw - max_log_weight));
+
+        std::discrete_distribution<IntType> choose_m(weights.begin(),
+                                                     weights.end());
+        IntType num_urns = 1 + choose_m(engine);
+
+        std::uniform_int_distribution<IntType> urn(0, num_urns - 1);
+        std::vector<IntType> relabel(num_urns, -1);
+        IntType num_blocks = 0;
+        for (auto& b : block_of)
+        {
+            IntType u = urn(engine);
+            if (relabel[u] == -1)
+                relabel[u] = num_blocks++;
+            b = relabel[u];
+        }
+
+        return num_blocks;
+    }
+
+    template <class Engine>
+    IntType random_blocks_stirling(std::vector<IntType>& block_of,
+                                   Engine& engine) const
+    {
+        // the Stirling numbers can be too big for an llint, so use logarithms
+        detail::log_counts<detail::stirling_partition_rule> log_S(
+          &stirling_partition_number<llint>, n_, min_num_parts_, max_num_parts_);
+
+        std::vector<double> weights;
+        for (IntType k = min_num_parts_; k <= max_num_parts_; ++k)
+            weights.push_back(log_S(n_, k));
+        double top = *std::max_element(weights.begin(), weights.end());
+        for (auto& w : weights)
+            w = std::exp(w - top);
+
+        std::discrete_distribution<IntType> choose_k(weights.begin(),
+                                                     weights.end());
+        IntType k = min_num_parts_ + choose_k(engine);
+        IntType num_blocks = k;
+
+        // Going backwards, decide for each element if it starts a block.
+        std::vector<bool> starts_block(n_);
+        std::uniform_real_distribution<double> U(0.0, 1.0);
+        for (IntType m = n_; m > 0; --m)
+        {
+            double p_new = std::exp(log_S(m - 1, k - 1) - log_S(m, k));
+            starts_block[m - 1] = (U(engine) < p_new);
+            if (starts_block[m - 1])
+                --k;
+        }
+
+        // Going forwards, the others join a uniformly random previous block.
+        k = 0;
+        for (IntType i = 0; i < n_; ++i)
+        {
+            if (starts_block[i])
+            {
+                block_of[i] = k++;
+                continue;
+            }
+            std::uniform_int_distribution<IntType> d(0, k - 1);
+            block_of[i] = d(engine);
+        }
+
+        return num_blocks;
+    }
+
     static difference_type pop(set_partition& data, IntType num)
     {
         const difference_type n = data.size();
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "IndexedView.hpp"
+
+namespace discreture
+{
+
+///////////////////////////////////////////////
+/// \brief A struct-of-arrays projection of a container of records: one
+/// contiguous column per chosen data member.
+///
+/// Meant to be combined with IndexedView and IndexedViewContainer, so that
+/// reading a couple of fields of the chosen records only touches those
+/// columns instead of whole records. Use lane<I>(x) on an element x of, say,
+/// combinations(soa, k) to get the I-th field of the chosen records.
+///
+/// # Example:
+///
+///     struct R { double weight; int value; std::string name; };
+///     std::vector<R> records = ...;
+///     auto S = soa_view(records, &R::weight, &R::value);
+///     for (auto&& x : combinations(S, 3))
+///     {
+///         auto w = lane<0>(x); // the weights of the 3 chosen records
+///         auto v = lane<1>(x); // their values
+///         double total = std::accumulate(w.begin(), w.end(), 0.0);
+///         ...
+///     }
+///
+/// The columns are a copy of the fields, made once on construction. Records
+/// as a whole can be read with record(i) (or S[i]), as tuples of references,
+/// so an IndexedView of an SoAView can also be iterated directly; but reading
+/// through lane<I> only touches the columns that are needed.
+///////////////////////////////////////////////
+template <class... Ts>
+class SoAView
+{
+public:
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<const Ts&...>;
+    using difference_type = std::ptrdiff_t;
+    using size_type = difference_type;
+
+    template <std::size_t I>
+    using column_type = std::vector<std::tuple_element_t<I, value_type>>;
+
+    static constexpr std::size_t num_columns = sizeof...(Ts);
+
+    template <class Container, class Record>
+    SoAView(const Container& records, Ts Record::*... members)
+        : size_(records.size())
+    {
+        reserve(std::index_sequence_for<Ts...>{});
+        for (auto&& r : records)
+            push_back(r, std::make_tuple(members...), std::index_sequence_for<Ts...>{});
+    }
+
+    size_type size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    //////////////////////////////////////////
+    /// \brief The I-th column, which is contiguous.
+    //////////////////////////////////////////
+    template <std::size_t I>
+    const column_type<I>& column() const
+    {
+        return std::get<I>(columns_);
+    }
+
+    //////////////////////////////////////////
+    /// \brief All projected fields of the i-th record.
+    //////////////////////////////////////////
+    reference record(size_type i) const
+    {
+        return record(i, std::index_sequence_for<Ts...>{});
+    }
+
+    reference operator[](size_type i) const { return record(i); }
+
+private:
+    std::tuple<std::vector<Ts>...> columns_;
+    size_type size_;
+
+    template <std::size_t... I>
+    void reserve(std::index_sequence<I...>)
+    {
+        using expander = int[];
+        (void)expander{0, (std::get<I>(columns_).reserve(size_), 0)...};
+    }
+
+    template <class Record, class Members, std::size_t... I>
+    void push_back(const Record& r, const Members& members, std::index_sequence<I...>)
+    {
+        using expander = int[];
+        (void)expander{
+          0, (std::get<I>(columns_).push_back(r.*std::get<I>(members)), 0)...};
+    }
+
+    template <std::size_t... I>
+    reference record(size_type i, std::index_sequence<I...>) const
+    {
+        return reference(std::get<I>(columns_)[i]...);
+    }
+};
+
+template <class... Ts>
+constexpr std::size_t SoAView<Ts...>::num_columns;
+
+// Utility function for C++14 and below, like make_shared.
+template <class Container, class Record, class... Ts>
+auto soa_view(const Container& records, Ts Record::*... members)
+{
+    return SoAView<Ts...>(records, members...);
+}
+
+//////////////////////////////////////////
+/// \brief The I-th field of the records chosen by an IndexedView over an
+/// SoAView, as an IndexedView over that column (so it can be iterated,
+/// reduced or gathered with materialize_into).
+///
+/// The result refers to x's objects and indices, so it must not outlive x's
+/// underlying containers.
+//////////////////////////////////////////
+template <std::size_t I, class SoA, class RAIndexContainer>
+auto lane(const IndexedView<SoA, RAIndexContainer>& x)
+{
+    return indexed_view(x.objects().template column<I>(), x.indices());
+}
+
+} // namespace discreture
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SIMD.hpp"
+
+// Vectorized scans for the colex successor and predecessor of combinations.
+// Only used for contiguous containers of 32 bit ints.
+
+namespace discreture
+{
+namespace detail
+{
+    namespace simd
+    {
+        // First i in [start,last) with data[i] + 1 != data[i+1], or last if
+        // none.
+        inline std::ptrdiff_t first_gap_scalar(const std::int32_t* data,
+                                               std::ptrdiff_t start,
+                                               std::ptrdiff_t last)
+        {
+            std::ptrdiff_t i = start;
+            for (; i < last && (data[i] + 1 == data[i + 1]); ++i) {}
+            return i;
+        }
+
+        // First i in [start,last) with data[i] != i, or last if none.
+        inline std::ptrdiff_t first_non_fixed_scalar(const std::int32_t* data,
+                                                     std::ptrdiff_t start,
+                                                     std::ptrdiff_t last)
+        {
+            std::ptrdiff_t i = start;
+            for (; i < last && (data[i] == i); ++i) {}
+            return i;
+        }
+
+#ifdef DISCRETURE_X86_SIMD
+        __attribute__((target("avx2"))) inline std::ptrdiff_t
+        first_gap_avx2(const std::int32_t* data,
+                       std::ptrdiff_t start,
+                       std::ptrdiff_t last)
+        {
+            const __m256i one = _mm256_set1_epi32(1);
+            std::ptrdiff_t i = start;
+
+            // compares data[i..i+7]+1 against data[i+1..i+8]
+            for (; i + 8 <= last; i += 8)
+            {
+                auto a = _mm256_loadu_si256(
+                  reinterpret_cast<const __m256i*>(data + i));
+                auto b = _mm256_loadu_si256(
+                  reinterpret_cast<const __m256i*>(data + i + 1));
+                auto eq = _mm256_cmpeq_epi32(_mm256_add_epi32(a, one), b);
+                unsigned mask =
+                  ~unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(eq))) &
+                  0xFFU;
+                if (mask != 0)
+                    return i + __builtin_ctz(mask);
+            }
+
+            for (; i < last && (data[i] + 1 == data[i + 1]); ++i) {}
+            return i;
+        }
+
+        __attribute__((target("avx2"))) inline std::ptrdiff_t
+        first_non_fixed_avx2(const std::int32_t* data,
+                             std::ptrdiff_t start,
+                             std::ptrdiff_t last)
+        {
+            const __m256i eight = _mm256_set1_epi32(8);
+            __m256i idx =
+              _mm256_add_epi32(_mm256_set1_epi32(start),
+                               _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            std::ptrdiff_t i = start;
+
+            for (; i + 8 <= last; i += 8)
+            {
+                auto a = _mm256_loadu_si256(
+                  reinterpret_cast<const __m256i*>(data + i));
+                auto eq = _mm256_cmpeq_epi32(a, idx);
+                unsigned mask =
+                  ~unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(eq))) &
+                  0xFFU;
+                if (mask != 0)
+                    return i + __builtin_ctz(mask);
+                idx = _mm256_add_epi32(idx, eight);
+            }
+
+            for (; i < last && (data[i] == i); ++i) {}
+            return i;
+        }
+
+        // The tail is handled with masked loads, so no scalar loop is needed.
+        __attribute__((target("avx512f"))) inline std::ptrdiff_t
+        first_gap_avx512(const std::int32_t* data,
+                         std::ptrdiff_t start,
+                         std::ptrdiff_t last)
+        {
+            const __m512i one = _mm512_set1_epi32(1);
+
+            for (std::ptrdiff_t i = start; i < last; i += 16)
+            {
+                auto remaining = last - i;
+                __mmask16 valid = remaining >= 16
+                  ? __mmask16(0xFFFF)
+                  : __mmask16((1U << remaining) - 1U);
+                auto a = _mm512_maskz_loadu_epi32(valid, data + i);
+                auto b = _mm512_maskz_loadu_epi32(valid, data + i + 1);
+                unsigned mask = _mm512_mask_cmpneq_epi32_mask(
+                  valid, _mm512_add_epi32(a, one), b);
+                if (mask != 0)
+                    return i + __builtin_ctz(mask);
+            }
+
+            return last;
+        }
+
+        __attribute__((target("avx512f"))) inline std::ptrdiff_t
+        first_non_fixed_avx512(const std::int32_t* data,
+                               std::ptrdiff_t start,
+                               std::ptrdiff_t last)
+        {
+            const __m512i sixteen = _mm512_set1_epi32(16);
+            __m512i idx = _mm512_add_epi32(
+              _mm512_set1_epi32(start),
+              _mm512_setr_epi32(
+                0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+            for (std::ptrdiff_t i = start; i < last; i += 16)
+            {
+                auto remaining = last - i;
+                __mmask16 valid = remaining >= 16
+                  ? __mmask16(0xFFFF)
+                  : __mmask16((1U << remaining) - 1U);
+                auto a = _mm512_maskz_loadu_epi32(valid, data + i);
+                unsigned mask = _mm512_mask_cmpneq_epi32_mask(valid, a, idx);
+                if (mask != 0)
+                    return i + __builtin_ctz(mask);
+                idx = _mm512_add_epi32(idx, sixteen);
+            }
+
+            return last;
+        }
+#endif
+
+        inline std::ptrdiff_t first_gap(const std::int32_t* data,
+                                        std::ptrdiff_t start,
+                                        std::ptrdiff_t last)
+        {
+#ifdef DISCRETURE_X86_SIMD
+            switch (cpu_level())
+            {
+            case level::avx512: return first_gap_avx512(data, start, last);
+            case level::avx2: return first_gap_avx2(data, start, last);
+            default: break;
+            }
+#endif
+            return first_gap_scalar(data, start, last);
+        }
+
+        inline std::ptrdiff_t first_non_fixed(const std::int32_t* data,
+                                              std::ptrdiff_t start,
+                                              std::ptrdiff_t last)
+        {
+#ifdef DISCRETURE_X86_SIMD
+            switch (cpu_level())
+            {
+            case level::avx512: return first_non_fixed_avx512(data, start, last);
+            case level::avx2: return first_non_fixed_avx2(data, start, last);
+            default: break;
+            }
+#endif
+            return first_non_fixed_scalar(data, start, last);
+        }
+
+    } // namespace simd
+} // namespace detail
+} // namespace discreture
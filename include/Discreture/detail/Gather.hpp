@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "SIMD.hpp"
+
+// out[i] = objects[idx[i]] for i in [0,n), as fast as the element type allows:
+// AVX2 gathers for 4 and 8 byte arithmetic types with int indices, memcpy for
+// trivially copyable types and plain assignment for everything else.
+
+namespace discreture
+{
+namespace detail
+{
+    // Containers whose elements are contiguous and can be read through a
+    // const pointer returned by data().
+    template <class Container, class = void>
+    struct has_contiguous_data : std::false_type
+    {};
+
+    template <class Container>
+    struct has_contiguous_data<
+      Container,
+      std::enable_if_t<std::is_same<
+        decltype(std::declval<const Container&>().data()),
+        const typename Container::value_type*>::value>> : std::true_type
+    {};
+
+    namespace simd
+    {
+#ifdef DISCRETURE_X86_SIMD
+        // 4 byte elements, 8 at a time
+        __attribute__((target("avx2"))) inline std::ptrdiff_t
+        gather_avx2(const std::int32_t* objects,
+                    const std::int32_t* idx,
+                    std::ptrdiff_t n,
+                    std::int32_t* out)
+        {
+            std::ptrdiff_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto vidx =
+                  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + i));
+                auto v = _mm256_i32gather_epi32(
+                  reinterpret_cast<const int*>(objects), vidx, 4);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+            }
+            return i;
+        }
+
+        // 8 byte elements, 4 at a time
+        __attribute__((target("avx2"))) inline std::ptrdiff_t
+        gather_avx2(const std::int64_t* objects,
+                    const std::int32_t* idx,
+                    std::ptrdiff_t n,
+                    std::int64_t* out)
+        {
+            std::ptrdiff_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                auto vidx =
+                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx + i));
+                auto v = _mm256_i32gather_epi64(
+                  reinterpret_cast<const long long*>(objects), vidx, 8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+            }
+            return i;
+        }
+#endif
+
+        // Returns how many elements were gathered with vector instructions
+        // (the caller does the rest).
+        template <class T, class Index>
+        std::ptrdiff_t gather_prefix(const T* objects,
+                                     const Index* idx,
+                                     std::ptrdiff_t n,
+                                     T* out)
+        {
+#ifdef DISCRETURE_X86_SIMD
+            using word = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+
+            constexpr bool gatherable = std::is_arithmetic<T>::value &&
+              (sizeof(T) == 4 || sizeof(T) == 8) &&
+              std::is_integral<Index>::value && sizeof(Index) == 4;
+
+            if (gatherable && cpu_level() != level::scalar)
+            {
+                // Only reinterpreting bits, so this is fine for float/double.
+                return gather_avx2(reinterpret_cast<const word*>(objects),
+                                   reinterpret_cast<const std::int32_t*>(idx),
+                                   n,
+                                   reinterpret_cast<word*>(out));
+            }
+#endif
+            (void)objects;
+            (void)idx;
+            (void)n;
+            (void)out;
+            return 0;
+        }
+    } // namespace simd
+
+    template <class T, class Index>
+    void gather(const T* objects, const Index* idx, std::ptrdiff_t n, T* out)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "gather needs trivially copyable elements");
+
+        std::ptrdiff_t i = simd::gather_prefix(objects, idx, n, out);
+
+        for (; i < n; ++i)
+            std::memcpy(out + i, objects + idx[i], sizeof(T));
+    }
+
+} // namespace detail
+} // namespace discreture
@@ -2,6 +2,7 @@
 
 #include "../Misc.hpp"
 #include "../VectorHelpers.hpp"
+#include <algorithm>
 
 namespace discreture
 {
@@ -49,6 +50,74 @@ namespace detail
             UNUSED(i);
         }
     };
+
+    // Same as for_each_multiset, but only the submultisets of size k, in the
+    // same order.
+    template <class multiset, int _size>
+    struct for_each_multiset_of_size
+    {
+        using idx = typename multiset::value_type;
+
+        template <class Func>
+        static void apply(const multiset& total, idx k, Func f)
+        {
+            // below[i] is how much fits in x[0], ..., x[i-1]
+            multiset below(_size + 1, 0);
+            for (int i = 0; i < _size; ++i)
+                below[i + 1] = below[i] + total[i];
+            if (k < 0 || k > below[_size])
+                return;
+
+            multiset x(_size);
+            for_loop(x, total, below, _size - 1, k, f);
+        }
+
+        template <class Func>
+        static void for_loop(multiset& x,
+                             const multiset& total,
+                             const multiset& below,
+                             idx i,
+                             idx left,
+                             Func f)
+        {
+            idx hi = std::min(total[i], left);
+            for (x[i] = std::max<idx>(0, left - below[i]); x[i] <= hi; ++x[i])
+            {
+                for_each_multiset_of_size<multiset, _size - 1>::for_loop(
+                  x, total, below, i - 1, left - x[i], f);
+            }
+        }
+    };
+
+    template <class multiset>
+    struct for_each_multiset_of_size<multiset, 0>
+    {
+        using idx = typename multiset::value_type;
+
+        template <class Func>
+        static void apply(const multiset& total, idx k, Func f)
+        {
+            multiset x(0);
+            if (k == 0)
+                f(x);
+            UNUSED(total);
+        }
+
+        template <class Func>
+        static void for_loop(multiset& x,
+                             const multiset& total,
+                             const multiset& below,
+                             idx i,
+                             idx left,
+                             Func f)
+        {
+            f(x);
+            UNUSED(total);
+            UNUSED(below);
+            UNUSED(i);
+            UNUSED(left);
+        }
+    };
 } // namespace detail
 
 } // namespace discreture
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "../hedley.h"
+
+// Runtime detection of vector instruction sets, shared by everything that has
+// a vectorized path. Only x86 with gcc or clang is supported; everything else
+// (or defining DISCRETURE_NO_SIMD) uses the scalar code.
+#if !defined(DISCRETURE_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) &&  \
+  (defined(__x86_64__) || defined(__i386__))
+#define DISCRETURE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace discreture
+{
+namespace detail
+{
+    namespace simd
+    {
+        enum class level : int
+        {
+            scalar = 0,
+            avx2,
+            avx512
+        };
+
+        //////////////////////////////////////////
+        /// \brief What the current CPU supports, detected once at runtime.
+        //////////////////////////////////////////
+        inline level cpu_level()
+        {
+#ifdef DISCRETURE_X86_SIMD
+            static const level L = []() {
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f"))
+                    return level::avx512;
+                if (__builtin_cpu_supports("avx2"))
+                    return level::avx2;
+                return level::scalar;
+            }();
+            return L;
+#else
+            return level::scalar;
+#endif
+        }
+
+        // Containers for which we can get an int32_t* to the elements
+        template <class Container, class = void>
+        struct is_contiguous_int32 : std::false_type
+        {};
+
+        template <class Container>
+        struct is_contiguous_int32<
+          Container,
+          std::enable_if_t<std::is_same<typename Container::value_type,
+                                        std::int32_t>::value &&
+                           std::is_same<decltype(std::declval<Container&>().data()),
+                                        std::int32_t*>::value>> : std::true_type
+        {};
+
+    } // namespace simd
+} // namespace detail
+} // namespace discreture
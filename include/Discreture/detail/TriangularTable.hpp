@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// Lower triangular tables T(n,k), 0 <= k <= n, stored row after row in one
+// contiguous array, so T(n,k) is at n(n+1)/2 + k. Used by the two-parameter
+// sequences (partition numbers with k parts, Stirling numbers) in
+// Sequences.hpp.
+//
+// A Rule says how to compute T(n,k) from the rows above it:
+//
+//     struct Rule
+//     {
+//         static constexpr long long value(const long long* t, long long n, long long k);
+//     };
+//
+// where t points to the table (use triangle_at to read it). The first rows
+// are computed at compile time, the rest on demand. The entries are
+// nonnegative, and those that don't fit in a long long are triangle_overflow
+// (rules combine them with saturating_add and saturating_mul, so this never
+// overflows).
+
+namespace discreture
+{
+namespace detail
+{
+    constexpr std::size_t triangle_index(long long n, long long k)
+    {
+        return static_cast<std::size_t>(n)*static_cast<std::size_t>(n + 1)/2 +
+          static_cast<std::size_t>(k);
+    }
+
+    constexpr long long triangle_overflow = std::numeric_limits<long long>::max();
+
+    // a + b for a, b >= 0, or triangle_overflow if it doesn't fit.
+    constexpr long long saturating_add(long long a, long long b)
+    {
+        return (a > triangle_overflow - b) ? triangle_overflow : a + b;
+    }
+
+    // a*b for a, b >= 0, or triangle_overflow if it doesn't fit.
+    constexpr long long saturating_mul(long long a, long long b)
+    {
+        return (a != 0 && b > triangle_overflow/a) ? triangle_overflow : a*b;
+    }
+
+    // T(n,k), or 0 outside of the triangle.
+    constexpr long long triangle_at(const long long* t, long long n, long long k)
+    {
+        return (n < 0 || k < 0 || k > n) ? 0 : t[triangle_index(n, k)];
+    }
+
+    template <class Rule, std::size_t Rows>
+    struct constexpr_triangle
+    {
+        long long data[Rows*(Rows + 1)/2];
+
+        constexpr constexpr_triangle() : data{}
+        {
+            for (std::size_t n = 0; n < Rows; ++n)
+                for (std::size_t k = 0; k <= n; ++k)
+                    data[triangle_index(n, k)] = Rule::value(data, n, k);
+        }
+
+        constexpr long long operator()(long long n, long long k) const
+        {
+            return data[triangle_index(n, k)];
+        }
+    };
+
+    template <class Rule>
+    class triangle_table
+    {
+    public:
+        // Don't compute more than this many rows that weren't asked for.
+        static constexpr long long max_extra_rows = 64;
+
+        template <std::size_t Rows>
+        explicit triangle_table(const constexpr_triangle<Rule, Rows>& prefix)
+            : data_(std::begin(prefix.data), std::end(prefix.data)), rows_(Rows)
+        {}
+
+        long long rows() const { return rows_; }
+
+        long long operator()(long long n, long long k)
+        {
+            if (n >= rows_)
+                extend(n);
+            return data_[triangle_index(n, k)];
+        }
+
+    private:
+        std::vector<long long> data_;
+        long long rows_;
+
+        // Grows geometrically, but at most max_extra_rows past row n.
+        void extend(long long n)
+        {
+            long long new_rows =
+              std::max(n + 1, std::min(2*rows_, n + 1 + max_extra_rows));
+            data_.resize(triangle_index(new_rows, 0));
+
+            for (long long m = rows_; m < new_rows; ++m)
+                for (long long k = 0; k <= m; ++k)
+                    data_[triangle_index(m, k)] = Rule::value(data_.data(), m, k);
+
+            rows_ = new_rows;
+        }
+    };
+
+    template <class Rule>
+    constexpr long long triangle_table<Rule>::max_extra_rows;
+
+    // T(n,k) for 0 <= k <= n, from the compile time prefix if possible.
+    template <class Rule, std::size_t PrefixRows>
+    long long triangle_lookup(long long n, long long k)
+    {
+        static constexpr constexpr_triangle<Rule, PrefixRows> prefix{};
+
+        if (n < static_cast<long long>(PrefixRows))
+            return prefix(n, k);
+
+        static triangle_table<Rule> table(prefix);
+        return table(n, k);
+    }
+
+    // log(e^a + e^b), without overflowing
+    inline double log_add(double a, double b)
+    {
+        double hi = std::max(a, b);
+        double lo = std::min(a, b);
+        if (lo == -std::numeric_limits<double>::infinity())
+            return hi;
+        return hi + std::log1p(std::exp(lo - hi));
+    }
+
+    // log T(m,j) for 0 <= m <= n and 0 <= j <= K, with the same recurrence
+    // in floating point (Rule::log_value), for when the numbers are too big
+    // for the integer tables. Takes O(n*K) time and memory.
+    template <class Rule>
+    class log_triangle
+    {
+    public:
+        log_triangle(long long n, long long K)
+            : K_(std::max(K, 0LL)), data_((n + 1)*(K_ + 1))
+        {
+            for (long long m = 0; m <= n; ++m)
+                for (long long j = 0; j <= K_; ++j)
+                    data_[m*(K_ + 1) + j] = (j > m) ? zero() : Rule::log_value(*this, m, j);
+        }
+
+        static double zero() { return -std::numeric_limits<double>::infinity(); }
+
+        // log T(m,j), or -infinity outside of the triangle
+        double operator()(long long m, long long j) const
+        {
+            if (m < 0 || j < 0 || j > K_ || j > m)
+                return zero();
+            return data_[m*(K_ + 1) + j];
+        }
+
+    private:
+        long long K_;
+        std::vector<double> data_;
+    };
+
+    // log T(m,j) for the entries a random sampler walks through: it starts at
+    // some T(n,k) with min_k <= k <= max_k and only moves to smaller entries.
+    // If those T(n,k) fit in a long long, reads them with exact (which must
+    // return T(m,j), saturated); otherwise builds a log_triangle.
+    template <class Rule>
+    class log_counts
+    {
+    public:
+        using exact_function = long long (*)(long long, long long);
+
+        log_counts(exact_function exact, long long n, long long min_k, long long max_k)
+            : exact_(exact)
+        {
+            for (long long k = min_k; k <= max_k; ++k)
+            {
+                if (exact_(n, k) == triangle_overflow)
+                {
+                    logs_.reset(new log_triangle<Rule>(n, max_k));
+                    break;
+                }
+            }
+        }
+
+        double operator()(long long m, long long j) const
+        {
+            if (logs_)
+                return (*logs_)(m, j);
+            long long t = exact_(m, j);
+            return t == 0 ? log_triangle<Rule>::zero() : std::log(double(t));
+        }
+
+    private:
+        exact_function exact_;
+        std::unique_ptr<log_triangle<Rule>> logs_;
+    };
+
+    // partitions of n into exactly k parts
+    struct partition_rule
+    {
+        static constexpr long long value(const long long* t, long long n, long long k)
+        {
+            if (k == 0)
+                return n == 0;
+            return saturating_add(triangle_at(t, n - 1, k - 1), triangle_at(t, n - k, k));
+        }
+
+        template <class LogTable>
+        static double log_value(const LogTable& t, long long n, long long k)
+        {
+            if (k == 0)
+                return n == 0 ? 0.0 : LogTable::zero();
+            return log_add(t(n - 1, k - 1), t(n - k, k));
+        }
+    };
+
+    // permutations of n with k cycles
+    struct stirling_cycle_rule
+    {
+        static constexpr long long value(const long long* t, long long n, long long k)
+        {
+            if (n == 0)
+                return k == 0;
+            return saturating_add(saturating_mul(n - 1, triangle_at(t, n - 1, k)),
+                                  triangle_at(t, n - 1, k - 1));
+        }
+    };
+
+    // partitions of an n-set into k blocks
+    struct stirling_partition_rule
+    {
+        static constexpr long long value(const long long* t, long long n, long long k)
+        {
+            if (n == 0)
+                return k == 0;
+            return saturating_add(saturating_mul(k, triangle_at(t, n - 1, k)),
+                                  triangle_at(t, n - 1, k - 1));
+        }
+
+        template <class LogTable>
+        static double log_value(const LogTable& t, long long n, long long k)
+        {
+            if (n == 0)
+                return k == 0 ? 0.0 : LogTable::zero();
+            double a = (k == 0) ? LogTable::zero() : std::log(double(k)) + t(n - 1, k);
+            return log_add(a, t(n - 1, k - 1));
+        }
+    };
+
+} // namespace detail
+} // namespace discreture
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+// The 64x64 -> 128 bit multiplications and the bit tricks that the number
+// theory code needs. Uses unsigned __int128 and the gcc builtins where they
+// exist, the intrinsics on 64-bit MSVC, and plain 64-bit arithmetic
+// everywhere else.
+#if defined(__SIZEOF_INT128__)
+#define DISCRETURE_HAS_INT128 1
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define DISCRETURE_HAS_UMUL128 1
+#include <intrin.h>
+#endif
+
+namespace discreture
+{
+namespace detail
+{
+#ifdef DISCRETURE_HAS_INT128
+    __extension__ typedef unsigned __int128 uint128;
+#endif
+
+    // a*b = hi*2^64 + lo. Returns lo.
+    inline std::uint64_t mul128(std::uint64_t a, std::uint64_t b, std::uint64_t& hi)
+    {
+#if defined(DISCRETURE_HAS_INT128)
+        uint128 t = uint128(a)*b;
+        hi = static_cast<std::uint64_t>(t >> 64);
+        return static_cast<std::uint64_t>(t);
+#elif defined(DISCRETURE_HAS_UMUL128)
+        unsigned __int64 h;
+        std::uint64_t lo = _umul128(a, b, &h);
+        hi = h;
+        return lo;
+#else
+        const std::uint64_t mask = 0xFFFFFFFFULL;
+        std::uint64_t a0 = a & mask, a1 = a >> 32;
+        std::uint64_t b0 = b & mask, b1 = b >> 32;
+        std::uint64_t p00 = a0*b0, p01 = a0*b1, p10 = a1*b0, p11 = a1*b1;
+        std::uint64_t middle = (p00 >> 32) + (p01 & mask) + (p10 & mask);
+        hi = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+        return (middle << 32) | (p00 & mask);
+#endif
+    }
+
+    // floor(a*b/2^64)
+    inline std::uint64_t mulhi64(std::uint64_t a, std::uint64_t b)
+    {
+        std::uint64_t hi;
+        mul128(a, b, hi);
+        return hi;
+    }
+
+    // a*b mod n, for a, b < n
+    inline std::uint64_t mulmod64(std::uint64_t a, std::uint64_t b, std::uint64_t n)
+    {
+#ifdef DISCRETURE_HAS_INT128
+        return static_cast<std::uint64_t>(uint128(a)*b%n);
+#else
+        // double and add, so nothing overflows
+        std::uint64_t result = 0;
+        for (; b > 0; b >>= 1)
+        {
+            if (b & 1)
+                result = (result >= n - a) ? result - (n - a) : result + a;
+            a = (a >= n - a) ? a - (n - a) : a + a;
+        }
+        return result;
+#endif
+    }
+
+    // The number of trailing zero bits of x != 0
+    inline int ctz64(std::uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+#elif defined(DISCRETURE_HAS_UMUL128)
+        unsigned long i;
+        _BitScanForward64(&i, x);
+        return static_cast<int>(i);
+#else
+        int i = 0;
+        for (; (x & 1) == 0; x >>= 1)
+            ++i;
+        return i;
+#endif
+    }
+
+} // namespace detail
+} // namespace discreture
@@ -1,23 +1,37 @@
 #pragma once
 
+#include "Discreture/Aggregated.hpp"
+#include "Discreture/Calibration.hpp"
 #include "Discreture/CombinationTree.hpp"
 #include "Discreture/Combinations.hpp"
+#include "Discreture/Compositions.hpp"
+#include "Discreture/ConstexprTables.hpp"
 #include "Discreture/IndexedView.hpp"
 #include "Discreture/IndexedViewContainer.hpp"
 #include "Discreture/LexCombinations.hpp"
-// #include "Discreture/Derangements.hpp"
+#include "Discreture/Derangements.hpp"
 #include "Discreture/ArithmeticProgression.hpp"
 #include "Discreture/DyckPaths.hpp"
+#include "Discreture/GappedCombinations.hpp"
 #include "Discreture/IntegerInterval.hpp"
 #include "Discreture/Misc.hpp"
+#include "Discreture/Modular.hpp"
 #include "Discreture/Motzkin.hpp"
+#include "Discreture/MultiplicativeFunctions.hpp"
+#include "Discreture/MultiplicityPartitions.hpp"
+#include "Discreture/MultisetPermutations.hpp"
 #include "Discreture/Multisets.hpp"
+#include "Discreture/NumberTheory.hpp"
 #include "Discreture/Parallel.hpp"
 #include "Discreture/Partitions.hpp"
 #include "Discreture/Permutations.hpp"
+#include "Discreture/PowerSeries.hpp"
 #include "Discreture/Probability.hpp"
+#include "Discreture/RestrictedPartitions.hpp"
 #include "Discreture/Reversed.hpp"
+#include "Discreture/Sampling.hpp"
 #include "Discreture/SetPartitions.hpp"
+#include "Discreture/SoAView.hpp"
 #include "Discreture/TimeHelpers.hpp"
 #include "Discreture/VectorHelpers.hpp"
 
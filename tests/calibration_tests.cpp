@@ -0,0 +1,85 @@
+#include "Discreture/Calibration.hpp"
+#include "Discreture/Combinations.hpp"
+#include "Discreture/LexCombinations.hpp"
+#include "Discreture/Permutations.hpp"
+#include "common_tests.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace std;
+using namespace discreture;
+
+template <class Container>
+void check_jumps(const Container& X)
+{
+    for (std::ptrdiff_t jump : {1, 3, 17, 45, 101})
+    {
+        auto it = X.begin();
+        auto rit = X.rbegin();
+        for (std::ptrdiff_t i = 0; i + jump < X.size(); i += jump)
+        {
+            ASSERT_EQ(*it, X[i]);
+            ASSERT_EQ(*rit, X[X.size() - 1 - i]);
+            it += jump;
+            rit += jump;
+        }
+    }
+}
+
+TEST(Calibration, ThresholdsAreSane)
+{
+    for (int k = 0; k < 12; ++k)
+    {
+        auto t = Combinations<int>::crossover_threshold(k);
+        ASSERT_GE(t, 1);
+        ASSERT_LE(t, std::ptrdiff_t(CrossoverTable::max_threshold));
+        ASSERT_EQ(crossover_table().peek(crossover_family::combinations, k), t);
+    }
+}
+
+TEST(Calibration, AdvanceIsCorrectWhateverTheThreshold)
+{
+    auto& table = crossover_table();
+    for (std::ptrdiff_t t : {1, 2, 50, 4096})
+    {
+        for (int k = 0; k < 7; ++k)
+        {
+            for (int f = 0; f < CrossoverTable::num_families; ++f)
+                table.set(static_cast<crossover_family>(f), k, t);
+        }
+        check_jumps(combinations(14, 5));
+        check_jumps(lex_combinations(14, 5));
+        check_jumps(permutations(6));
+    }
+    table.reset();
+}
+
+TEST(Calibration, SaveAndLoadProfile)
+{
+    CrossoverTable A;
+    A.set(crossover_family::combinations, 3, 17);
+    A.set(crossover_family::permutations_reverse, 9, 4);
+    A.set(crossover_family::lex_combinations, 80, 5); // ignored: k too large
+
+    std::stringstream ss;
+    A.save(ss);
+
+    CrossoverTable B;
+    ASSERT_EQ(B.load(ss), 2);
+    ASSERT_EQ(B.peek(crossover_family::combinations, 3), 17);
+    ASSERT_EQ(B.peek(crossover_family::permutations_reverse, 9), 4);
+    ASSERT_EQ(B.peek(crossover_family::combinations, 4), 0);
+
+    std::stringstream garbage("bla 3 4\ncombinations x 3\n\ncombinations 2 9\n");
+    ASSERT_EQ(B.load(garbage), 1);
+    ASSERT_EQ(B.peek(crossover_family::combinations, 2), 9);
+}
+
+TEST(Calibration, UseDefaults)
+{
+    CrossoverTable A;
+    A.use_defaults();
+    ASSERT_EQ(A.peek(crossover_family::combinations, 5), 40);
+    auto t = A.get(crossover_family::combinations, 5, []() { return 1; });
+    ASSERT_EQ(t, 40);
+}
@@ -1,8 +1,11 @@
 #include "Discreture/Combinations.hpp"
+#include "Discreture/GappedCombinations.hpp"
 #include "Discreture/IntegerInterval.hpp"
 #include "common_tests.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
+#include <limits>
+#include <numeric>
 
 using namespace std;
 using namespace discreture;
@@ -214,3 +217,289 @@ TEST(Combinations, next_combination)
         ++i;
     } while (discreture::Combinations<int>::next_combination(n, A));
 }
+
+TEST(Combinations, VectorizedSuccessorMatchesScalar)
+{
+    // Combinations<int> uses the vectorized scan (if the cpu supports it),
+    // Combinations<long> always the scalar one.
+    for (int k = 8; k <= 24; k += 4)
+    {
+        int n = k + 5;
+        auto X = Combinations<int>(n, k);
+        auto Y = Combinations<long>(n, k);
+        auto y = Y.begin();
+        for (const auto& x : X)
+        {
+            ASSERT_TRUE(std::equal(x.begin(), x.end(), y->begin()));
+            ++y;
+        }
+
+        auto ry = Y.rbegin();
+        for (auto rx = X.rbegin(); rx != X.rend(); ++rx, ++ry)
+        {
+            ASSERT_TRUE(std::equal(rx->begin(), rx->end(), ry->begin()));
+        }
+    }
+}
+
+TEST(Combinations, RandomIsUniform)
+{
+    test_random_is_uniform(combinations(7, 3));
+    test_random_is_uniform(combinations(6, 0));
+    test_random_is_uniform(combinations(6, 6));
+    test_random_is_uniform(combinations_stack(8, 5), 100);
+
+    // way more than 2^63 combinations
+    std::mt19937_64 engine(1);
+    auto x = combinations(1000, 500).random(engine);
+    ASSERT_EQ(x.size(), 500);
+    ASSERT_TRUE(std::is_sorted(x.begin(), x.end()));
+    ASSERT_EQ(std::adjacent_find(x.begin(), x.end()), x.end());
+    ASSERT_GE(x.front(), 0);
+    ASSERT_LT(x.back(), 1000);
+}
+
+TEST(Combinations, Aggregated)
+{
+    for (int n = 0; n < 12; ++n)
+    {
+        std::vector<long> w;
+        for (int i = 0; i < n; ++i)
+            w.push_back((i*37)%11 - 4);
+
+        for (int k = 0; k <= n; ++k)
+        {
+            auto X = combinations(n, k);
+            auto A = X.aggregated(0L,
+                                  [&w](long& s, int x) { s += w[x]; },
+                                  [&w](long& s, int x) { s -= w[x]; });
+            ASSERT_EQ(A.size(), X.size());
+
+            auto it = X.begin();
+            for (auto&& a : A)
+            {
+                ASSERT_EQ(a.elements, *it);
+                long sum = 0;
+                for (auto x : a.elements)
+                    sum += w[x];
+                ASSERT_EQ(a.aggregate, sum);
+                ++it;
+            }
+            ASSERT_EQ(it, X.end());
+        }
+    }
+
+    // xor of hashes
+    std::vector<std::uint64_t> h = {0x1234, 0xFF00, 0x0F0F, 0xAAAA, 0x5555, 0x8001, 0x7777};
+    auto xor_in = [&h](std::uint64_t& s, int x) { s ^= h[x]; };
+    for (auto&& a : combinations(7, 4).aggregated(std::uint64_t(0), xor_in, xor_in))
+    {
+        std::uint64_t expected = 0;
+        for (auto x : a.elements)
+            expected ^= h[x];
+        ASSERT_EQ(a.aggregate, expected);
+    }
+}
+
+TEST(Combinations, FindAllStateful)
+{
+    for (int n = 0; n < 12; ++n)
+    {
+        for (int k = 0; k <= n; ++k)
+        {
+            int bound = n + k;
+            auto push = [bound](int sum, int x) -> boost::optional<int> {
+                if (sum + x > bound)
+                    return boost::none;
+                return sum + x;
+            };
+
+            auto X = combinations(n, k);
+            auto T = X.find_all(0, push);
+
+            std::vector<decltype(X)::combination> expected;
+            for (auto&& x : X)
+                if (std::accumulate(x.begin(), x.end(), 0) <= bound)
+                    expected.push_back(x);
+            std::sort(expected.begin(), expected.end());
+
+            std::vector<decltype(X)::combination> found;
+            for (auto it = T.begin(); it != T.end(); ++it)
+            {
+                ASSERT_EQ(it.state(), std::accumulate(it->begin(), it->end(), 0));
+                found.push_back(*it);
+            }
+            ASSERT_EQ(found, expected);
+        }
+    }
+
+    // No two consecutive elements: the state is just the last element.
+    auto T = combinations(9, 3).find_all(-2, [](int last, int x) -> boost::optional<int> {
+        if (x == last + 1)
+            return boost::none;
+        return x;
+    });
+    ASSERT_EQ(std::distance(T.begin(), T.end()), 35); // binomial(7,3)
+}
+
+TEST(Combinations, CountAll)
+{
+    auto identity = [](int s) { return s; };
+
+    for (int n = 0; n < 14; ++n)
+    {
+        for (int k = 0; k <= n; ++k)
+        {
+            int bound = n + k;
+            auto push = [bound](int sum, int x) -> boost::optional<int> {
+                if (sum + x > bound)
+                    return boost::none;
+                return sum + x;
+            };
+
+            auto X = combinations(n, k);
+            auto T = X.find_all(0, push);
+            std::ptrdiff_t expected = std::distance(T.begin(), T.end());
+            ASSERT_EQ(X.count_all(0, push, identity), expected);
+            ASSERT_EQ(X.count_all(0, push, identity, 3), expected);
+        }
+    }
+
+    // Subsets of size 30 of {0,...,59} whose sum is divisible by 7: far too
+    // many to enumerate, but the state (size, sum mod 7) takes few values.
+    auto mod7 = [](int s, int x) -> boost::optional<int> {
+        int size = s/7 + 1;
+        int r = (s%7 + x)%7;
+        if (size == 30 && r != 0)
+            return boost::none;
+        return size*7 + r;
+    };
+    auto X = combinations(60, 30);
+    auto count = X.count_all(0, mod7, identity);
+    ASSERT_EQ(count, X.count_all(0, mod7, identity, 4));
+
+    std::vector<std::vector<std::ptrdiff_t>> ways(31, std::vector<std::ptrdiff_t>(7, 0));
+    ways[0][0] = 1;
+    for (int x = 0; x < 60; ++x)
+        for (int j = 30; j >= 1; --j)
+            for (int r = 0; r < 7; ++r)
+                ways[j][(r + x)%7] += ways[j - 1][r];
+    ASSERT_EQ(count, ways[30][0]);
+}
+
+TEST(Combinations, FindAllIterator)
+{
+    auto no_consecutive = [](const auto& comb) {
+        auto k = comb.size();
+        return k < 2 || comb[k - 1] != comb[k - 2] + 1;
+    };
+
+    auto X = combinations(12, 4);
+    auto T = X.find_all(no_consecutive);
+    auto S = X.find_all_stack<8>(no_consecutive);
+
+    auto s = S.begin();
+    std::ptrdiff_t id = 0;
+    for (auto t = T.begin(); t != T.end(); ++t, ++s, ++id)
+    {
+        ASSERT_NE(s, S.end());
+        ASSERT_EQ(t.ID(), id);
+        ASSERT_EQ(s.ID(), id);
+        ASSERT_TRUE(std::equal(t->begin(), t->end(), s->begin(), s->end()));
+
+        auto copy = t;
+        ASSERT_EQ(copy, t);
+        ++copy;
+        ASSERT_NE(copy, t);
+    }
+    ASSERT_EQ(s, S.end());
+    ASSERT_EQ(id, 126); // binomial(9,4)
+
+    // stateful predicates can be passed by reference
+    int calls = 0;
+    auto counting = [&calls, no_consecutive](const auto& comb) {
+        ++calls;
+        return no_consecutive(comb);
+    };
+    auto R = X.find_all(std::ref(counting));
+    ASSERT_EQ(std::distance(R.begin(), R.end()), 126);
+    ASSERT_GT(calls, 0);
+}
+
+TEST(Combinations, Gapped)
+{
+    for (int n = 0; n < 12; ++n)
+    {
+        for (int k = 0; k <= n + 1; ++k)
+        {
+            for (int d = 1; d <= 4; ++d)
+            {
+                auto X = gapped_combinations(n, k, d);
+
+                std::vector<std::vector<int>> expected;
+                for (auto& x : combinations(n, k))
+                {
+                    bool ok = true;
+                    for (int i = 0; i + 1 < k; ++i)
+                        ok = ok && x[i + 1] - x[i] >= d;
+                    if (ok)
+                        expected.push_back(x);
+                }
+                ASSERT_EQ(X.size(), expected.size());
+                ASSERT_EQ(std::vector<std::vector<int>>(X.begin(), X.end()), expected);
+
+                auto check = [](const auto&) {};
+                test_container_full(X, check);
+                test_container_foreach(X);
+                for (int i = 0; i < X.size(); ++i)
+                    ASSERT_EQ(X.get_index(X[i]), i);
+            }
+        }
+    }
+}
+
+TEST(Combinations, MaxGap)
+{
+    for (int n = 0; n < 12; ++n)
+    {
+        for (int k = 0; k <= n + 1; ++k)
+        {
+            for (int D = 1; D <= 4; ++D)
+            {
+                auto X = max_gap_combinations(n, k, D);
+
+                std::vector<std::vector<int>> expected;
+                for (auto& x : combinations(n, k))
+                {
+                    bool ok = true;
+                    for (int i = 0; i + 1 < k; ++i)
+                        ok = ok && x[i + 1] - x[i] <= D;
+                    if (ok)
+                        expected.push_back(x);
+                }
+                std::sort(expected.begin(), expected.end());
+                ASSERT_EQ(X.size(), expected.size());
+                ASSERT_EQ(std::vector<std::vector<int>>(X.begin(), X.end()), expected);
+
+                test_forward_iteration(X, [](const auto&) {});
+                test_container_foreach(X);
+                for (int i = 0; i < X.size(); ++i)
+                    ASSERT_EQ(X.get_index(X[i]), i);
+            }
+        }
+    }
+
+    // the largest counts that fit, and saturated ones
+    const auto saturated = std::numeric_limits<std::ptrdiff_t>::max();
+    ASSERT_EQ(max_gap_combinations(62, 31, 62).size(), binomial<llint>(62, 31));
+    ASSERT_EQ(max_gap_combinations(100, 37, 3).size(), 4202649788350674176LL);
+    ASSERT_EQ(max_gap_combinations(100, 38, 3).size(), saturated);
+    ASSERT_EQ(max_gap_combinations(120, 60, 120).size(), saturated);
+
+    auto Y = max_gap_combinations(100, 40, 3);
+    auto y = Y[1234567890123LL];
+    ASSERT_EQ(Y.get_index(y), 1234567890123LL);
+    auto it = Y.begin();
+    ++it;
+    ASSERT_EQ(*it, Y[1]);
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cmath>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <map>
+#include <random>
 
 #include "Discreture/IntegerInterval.hpp"
 #include "Discreture/Misc.hpp"
@@ -146,3 +149,32 @@ void test_container_foreach(const Container& X)
     });
     ASSERT_EQ(size, X.size());
 }
+
+// Draws many random elements and checks that they are all elements of C and
+// that every element appears roughly the same number of times.
+template <class Container>
+void test_random_is_uniform(const Container& C, int samples_per_element = 400)
+{
+    using elem_type = typename Container::value_type;
+    std::map<elem_type, int> count;
+    for (auto&& c : C)
+        count[c] = 0;
+
+    std::mt19937_64 engine(123456789);
+    int num_samples = samples_per_element*count.size();
+    for (int i = 0; i < num_samples; ++i)
+    {
+        auto x = C.random(engine);
+        auto it = count.find(x);
+        ASSERT_NE(it, count.end());
+        ++it->second;
+    }
+
+    // more than 6 standard deviations away is not going to happen by chance
+    double tolerance = 6.0*std::sqrt(double(samples_per_element));
+    for (auto&& kv : count)
+    {
+        ASSERT_GT(kv.second, samples_per_element - tolerance);
+        ASSERT_LT(kv.second, samples_per_element + tolerance);
+    }
+}
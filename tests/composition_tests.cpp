@@ -0,0 +1,88 @@
+#include "Discreture/Compositions.hpp"
+#include "common_tests.hpp"
+#include <gtest/gtest.h>
+#include <functional>
+#include <numeric>
+#include <set>
+
+using namespace std;
+using namespace discreture;
+
+namespace
+{
+// all compositions of n with parts >= m, with k parts in [a,b], by brute force
+std::set<compositions::composition> brute_compositions(int n, int a, int b, int m)
+{
+    std::set<compositions::composition> result;
+    for (int k = a; k <= b; ++k)
+    {
+        compositions::composition x(k, m);
+        std::function<void(int, int)> rec = [&](int i, int left) {
+            if (i == k)
+            {
+                if (left == 0)
+                    result.insert(x);
+                return;
+            }
+            for (int v = m; v <= left; ++v)
+            {
+                x[i] = v;
+                rec(i + 1, left - v);
+            }
+        };
+        rec(0, n);
+    }
+    return result;
+}
+} // namespace
+
+TEST(Compositions, Basic)
+{
+    std::vector<compositions::composition> expected = {
+      {4}, {1, 3}, {2, 2}, {3, 1}, {1, 1, 2}, {1, 2, 1}, {2, 1, 1}, {1, 1, 1, 1}};
+    compositions X(4);
+    ASSERT_EQ(std::vector<compositions::composition>(X.begin(), X.end()), expected);
+
+    for (int n = 0; n < 14; ++n)
+    {
+        compositions Y(n);
+        ASSERT_EQ(Y.size(), n == 0 ? 1 : 1 << (n - 1));
+        test_forward_iteration(Y, [n](const auto& x) {
+            ASSERT_EQ(std::accumulate(x.begin(), x.end(), 0), n);
+        });
+    }
+}
+
+TEST(Compositions, Restricted)
+{
+    for (int n = 0; n < 13; ++n)
+    {
+        for (int m = 1; m <= 4; ++m)
+        {
+            for (int a = 0; a <= n + 1; ++a)
+            {
+                for (int b = a; b <= n + 1; b += 2)
+                {
+                    compositions X(n, a, b, m);
+                    auto S = brute_compositions(n, a, b, m);
+                    ASSERT_EQ(X.size(), S.size()) << n << ' ' << a << ' ' << b << ' ' << m;
+
+                    std::vector<compositions::composition> V(X.begin(), X.end());
+                    ASSERT_EQ(std::set<compositions::composition>(V.begin(), V.end()), S);
+
+                    size_t i = 0;
+                    X.for_each([&](const compositions::composition& x) {
+                        ASSERT_EQ(x, V[i]);
+                        ASSERT_EQ(X[i], x);
+                        ASSERT_EQ(X.get_index(x), i);
+                        ++i;
+                    });
+                    ASSERT_EQ(i, V.size());
+                }
+            }
+        }
+    }
+
+    ASSERT_EQ(compositions(30, 10).size(), binomial(29, 9));
+    ASSERT_EQ(compositions::count(30, 5, 4), binomial(14, 4));
+}
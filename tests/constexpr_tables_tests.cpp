@@ -0,0 +1,100 @@
+#include "Discreture/Combinations.hpp"
+#include "Discreture/ConstexprTables.hpp"
+#include "Discreture/LexCombinations.hpp"
+#include "Discreture/Sequences.hpp"
+#include <gtest/gtest.h>
+
+using namespace discreture;
+
+namespace
+{
+constexpr auto F = compile_time::factorial_table<21>();
+constexpr auto B = compile_time::binomial_table<67>();
+constexpr auto C = compile_time::catalan_table<30>();
+constexpr auto M = compile_time::motzkin_table<30>();
+
+static_assert(F[0] == 1 && F[5] == 120 && F[20] == 2432902008176640000LL, "");
+static_assert(B[66][33] == 7219428434016265740LL && B[5][6] == 0, "");
+static_assert(C[4] == 14 && M[4] == 9, "");
+
+// the largest tables allowed
+constexpr auto C_max = compile_time::catalan_table<34>();
+constexpr auto M_max = compile_time::motzkin_table<42>();
+static_assert(C_max[33] == 212336130412243110LL, "");
+static_assert(M_max[41] == 192137918101841817LL, "");
+static_assert(compile_time::binomial(20, 6) == 38760, "");
+static_assert(compile_time::catalan(10) == 16796, "");
+static_assert(compile_time::motzkin(10) == 2188, "");
+
+// usable as a template argument
+static_assert(std::tuple_size<std::array<int, compile_time::factorial(5)>>::value == 120, "");
+
+constexpr auto C83 = compile_time::all_combinations<8, 3>();
+static_assert(C83.size() == 56, "");
+static_assert(C83[3][0] == 1 && C83[3][1] == 2 && C83[3][2] == 3, "");
+} // namespace
+
+TEST(ConstexprTables, Sequences)
+{
+    for (int n = 0; n < 21; ++n)
+        ASSERT_EQ(F[n], factorial(n));
+
+    for (int n = 0; n < 67; ++n)
+        for (int k = 0; k < 67; ++k)
+            ASSERT_EQ(B[n][k], binomial(n, k));
+
+    for (int n = 0; n < 30; ++n)
+    {
+        ASSERT_EQ(C[n], catalan(n));
+        ASSERT_EQ(C[n], compile_time::catalan(n));
+        ASSERT_EQ(M[n], motzkin(n));
+        ASSERT_EQ(M[n], compile_time::motzkin(n));
+    }
+}
+
+TEST(ConstexprTables, Combinations)
+{
+    static constexpr auto table = compile_time::all_combinations<10, 4>();
+    static constexpr auto lex_table = compile_time::all_lex_combinations<10, 4>();
+    static constexpr auto masks = compile_time::all_combination_masks<10, 4>();
+
+    auto X = combinations(10, 4);
+    ASSERT_EQ(table.size(), X.size());
+    std::size_t i = 0;
+    for (auto& x : X)
+    {
+        ASSERT_TRUE(std::equal(x.begin(), x.end(), table[i].begin()));
+
+        std::uint64_t mask = 0;
+        for (auto a : x)
+            mask |= std::uint64_t(1) << a;
+        ASSERT_EQ(masks[i], mask);
+        ++i;
+    }
+
+    auto L = lex_combinations(10, 4);
+    ASSERT_EQ(lex_table.size(), L.size());
+    i = 0;
+    for (auto& x : L)
+    {
+        ASSERT_TRUE(std::equal(x.begin(), x.end(), lex_table[i].begin()));
+        ++i;
+    }
+}
+
+TEST(ConstexprTables, CombinationsEdgeCases)
+{
+    static constexpr auto empty = compile_time::all_combinations<5, 0>();
+    ASSERT_EQ(empty.size(), 1);
+
+    static constexpr auto everything = compile_time::all_lex_combinations<5, 5>();
+    ASSERT_EQ(everything.size(), 1);
+    ASSERT_EQ(everything[0][4], 4);
+
+    static constexpr auto none = compile_time::all_combinations<3, 4>();
+    ASSERT_EQ(none.size(), 0);
+
+    static constexpr auto masks = compile_time::all_combination_masks<64, 1>();
+    ASSERT_EQ(masks.size(), 64);
+    ASSERT_EQ(masks[63], std::uint64_t(1) << 63);
+}
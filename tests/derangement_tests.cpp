@@ -0,0 +1,159 @@
+#include "Discreture/Derangements.hpp"
+#include "Discreture/Parallel.hpp"
+#include "common_tests.hpp"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <numeric>
+#include <set>
+
+using namespace std;
+using namespace discreture;
+
+namespace
+{
+// all permutations of {0,...,n-1} with x[i] != i for forbidden i, by brute force
+std::vector<derangements::derangement> brute_derangements(int n, const std::vector<bool>& forbidden)
+{
+    std::vector<derangements::derangement> result;
+    derangements::derangement x(n);
+    std::iota(x.begin(), x.end(), 0);
+    do
+    {
+        bool ok = true;
+        for (int i = 0; i < n; ++i)
+        {
+            if (forbidden[i] && x[i] == i)
+                ok = false;
+        }
+        if (ok)
+            result.push_back(x);
+    } while (std::next_permutation(x.begin(), x.end()));
+    return result;
+}
+
+template <class Family>
+void check_family(const Family& X, const std::vector<derangements::derangement>& expected)
+{
+    ASSERT_EQ(X.size(), expected.size());
+    ASSERT_EQ(std::vector<derangements::derangement>(X.begin(), X.end()), expected);
+    std::vector<derangements::derangement> backwards(X.rbegin(), X.rend());
+    std::reverse(backwards.begin(), backwards.end());
+    ASSERT_EQ(backwards, expected);
+
+    if (X.size() < 2000) // random jumps with dumb_advance are quadratic
+        test_container_full(X, [&X](const auto& x) { ASSERT_EQ(X[X.get_index(x)], x); });
+    test_container_foreach(X);
+    for (int i = 0; i < X.size(); ++i)
+        ASSERT_EQ(X.get_index(X[i]), i);
+}
+} // namespace
+
+TEST(Derangements, Basic)
+{
+    std::vector<long> subfactorial = {1, 0, 1, 2, 9, 44, 265, 1854, 14833};
+    for (int n = 0; n < 9; ++n)
+    {
+        derangements X(n);
+        ASSERT_EQ(X.size(), subfactorial[n]);
+        check_family(X, brute_derangements(n, std::vector<bool>(n, true)));
+    }
+
+    std::vector<derangements::derangement> expected = {
+      {1, 0, 3, 2}, {1, 2, 3, 0}, {1, 3, 0, 2}, {2, 0, 3, 1}, {2, 3, 0, 1},
+      {2, 3, 1, 0}, {3, 0, 1, 2}, {3, 2, 0, 1}, {3, 2, 1, 0}};
+    derangements Y(4);
+    ASSERT_EQ(std::vector<derangements::derangement>(Y.begin(), Y.end()), expected);
+}
+
+TEST(Derangements, ForbiddenFixedPoints)
+{
+    for (int n = 0; n < 7; ++n)
+    {
+        for (int subset = 0; subset < (1 << n); ++subset)
+        {
+            std::vector<int> points;
+            std::vector<bool> forbidden(n, false);
+            for (int i = 0; i < n; ++i)
+            {
+                if (subset & (1 << i))
+                {
+                    points.push_back(i);
+                    forbidden[i] = true;
+                }
+            }
+            derangements X(n, points);
+            check_family(X, brute_derangements(n, forbidden));
+        }
+    }
+
+    // nothing forbidden: all permutations
+    ASSERT_EQ(derangements(10, {}).size(), 3628800);
+}
+
+TEST(Derangements, Large)
+{
+    derangements X(20);
+    ASSERT_EQ(X.size(), 895014631192902121LL);
+
+    long long m = 123456789012345678LL;
+    auto x = X[m];
+    for (int i = 0; i < 20; ++i)
+        ASSERT_NE(x[i], i);
+    ASSERT_EQ(X.get_index(x), m);
+    auto it = X.begin() + m;
+    ASSERT_EQ(*it, x);
+    ++it;
+    ASSERT_EQ(*it, X[m + 1]);
+    --it;
+    --it;
+    ASSERT_EQ(*it, X[m - 1]);
+}
+
+TEST(Derangements, FromTheEnd)
+{
+    derangements X(7);
+    for (int m = 1; m <= 10; ++m)
+    {
+        ASSERT_EQ(*(X.end() - m), X[X.size() - m]);
+        ASSERT_EQ(*(X.rend() - m), X[m - 1]);
+    }
+    ASSERT_EQ(*(X.end() - X.size()), X[0]);
+    ASSERT_EQ(*(X.rend() - X.size()), X[X.size() - 1]);
+
+    auto it = X.end();
+    --it;
+    ASSERT_EQ(*it, X[X.size() - 1]);
+    auto rit = X.rend();
+    --rit;
+    ASSERT_EQ(*rit, X[0]);
+
+    // past the end by a long jump and back again
+    it = X.begin() + X.size();
+    ASSERT_EQ(it, X.end());
+    --it;
+    ASSERT_EQ(*it, X[X.size() - 1]);
+    ++it;
+    --it;
+    ASSERT_EQ(*it, X[X.size() - 1]);
+}
+
+TEST(Derangements, Parallel)
+{
+    derangements X(8);
+    std::mutex mut;
+    std::set<derangements::derangement> seen;
+    parallel_for_each(X.begin(),
+                      X.end(),
+                      [&](const auto& x) {
+                          std::lock_guard<std::mutex> lock(mut);
+                          seen.insert(x);
+                      },
+                      4);
+    ASSERT_EQ(seen.size(), X.size());
+}
+
+TEST(Derangements, RandomIsUniform)
+{
+    test_random_is_uniform(derangements(4));
+    test_random_is_uniform(derangements(5, {0, 2}), 100);
+}
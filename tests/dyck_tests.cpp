@@ -1,4 +1,5 @@
 #include "Discreture/DyckPaths.hpp"
+#include "common_tests.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
 #include <set>
@@ -35,3 +36,12 @@ TEST(DyckPaths, ForwardIteration)
         }
     }
 }
+
+TEST(DyckPaths, RandomIsUniform)
+{
+    for (int n = 0; n < 6; ++n)
+        test_random_is_uniform(dyck_paths(n));
+
+    std::mt19937_64 engine(1);
+    check_dyck_path(dyck_paths(500).random(engine));
+}
@@ -79,3 +79,62 @@ TEST(IndexedViewContainer, Permutations)
     auto U = discreture::permutations(A);
     check_indexed_view_container(U, A, discreture::permutations(n));
 }
+
+struct CopyCounter
+{
+    static int num_copies;
+    int value{0};
+
+    CopyCounter(int v) : value(v) {}
+    CopyCounter(const CopyCounter& other) : value(other.value) { ++num_copies; }
+    CopyCounter(CopyCounter&& other) = default;
+    CopyCounter& operator=(const CopyCounter& other)
+    {
+        value = other.value;
+        ++num_copies;
+        return *this;
+    }
+    CopyCounter& operator=(CopyCounter&& other) = default;
+
+    bool operator==(const CopyCounter& other) const
+    {
+        return value == other.value;
+    }
+};
+
+int CopyCounter::num_copies = 0;
+
+TEST(IndexedViewContainer, BorrowsLvaluesAndOwnsRvalues)
+{
+    std::vector<CopyCounter> A;
+    for (int i = 0; i < 7; ++i)
+        A.emplace_back(i);
+
+    CopyCounter::num_copies = 0;
+    auto U = combinations(A, 3);
+    auto L = lex_combinations(A, 3);
+    auto P = permutations(A);
+    ASSERT_EQ(CopyCounter::num_copies, 0);
+    check_indexed_view_container(U, A, combinations(7, 3));
+
+    // The view refers to A itself
+    A[0].value = 100;
+    ASSERT_EQ((*U.begin())[0].value, 100);
+    ASSERT_EQ((*L.begin())[0].value, 100);
+    ASSERT_EQ((*P.begin())[0].value, 100);
+
+    // Temporaries are moved in, and outlive the full expression
+    CopyCounter::num_copies = 0;
+    auto owned = combinations(std::vector<CopyCounter>(A), 2);
+    ASSERT_EQ(CopyCounter::num_copies, 7);
+    check_indexed_view_container(owned, A, combinations(7, 2));
+
+    auto owned_perms = permutations(std::vector<std::string>{"a", "b", "c"});
+    std::vector<std::string> B = {"a", "b", "c"};
+    check_indexed_view_container(owned_perms, B, permutations(3));
+
+    // integers still mean "the set {0,...,n-1}"
+    int n = 5;
+    int k = 2;
+    ASSERT_EQ(combinations(n, k).size(), 10);
+}
@@ -2,6 +2,8 @@
 #include "Discreture/IndexedView.hpp"
 #include "Discreture/Permutations.hpp"
 #include "generate_strings.hpp"
+#include <array>
+#include <cstdint>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <string>
@@ -56,3 +58,93 @@ TEST(IdxViews, Permutations)
         }
     }
 }
+
+struct Record
+{
+    int id;
+    double score;
+    char tag[3];
+
+    bool operator==(const Record& other) const
+    {
+        return id == other.id && score == other.score;
+    }
+};
+
+template <class T, class Index>
+void check_materialize(const std::vector<T>& objects, const std::vector<Index>& idx)
+{
+    auto V = discreture::indexed_view(objects, idx);
+    std::vector<T> out(idx.size() + 1, objects.front());
+    auto last = V.materialize_into(out.data());
+    ASSERT_EQ(last, out.data() + idx.size());
+    for (size_t i = 0; i < idx.size(); ++i)
+        ASSERT_EQ(out[i], objects[idx[i]]);
+
+    std::vector<T> copied;
+    V.materialize_into(std::back_inserter(copied));
+    ASSERT_EQ(copied, std::vector<T>(out.begin(), out.end() - 1));
+}
+
+template <class T, class Make>
+void check_materialize_all_index_types(Make make)
+{
+    std::vector<T> objects;
+    for (int i = 0; i < 50; ++i)
+        objects.push_back(make(i));
+
+    // lengths that are and aren't multiples of the vector width
+    for (int n : {0, 1, 3, 4, 8, 13, 17, 40})
+    {
+        std::vector<int> idx;
+        std::vector<long> long_idx;
+        for (int i = 0; i < n; ++i)
+        {
+            idx.push_back((i*7 + 3)%50);
+            long_idx.push_back((i*11 + 5)%50);
+        }
+        check_materialize(objects, idx);
+        check_materialize(objects, long_idx);
+    }
+}
+
+TEST(IdxViews, MaterializeInto)
+{
+    check_materialize_all_index_types<int>([](int i) { return i*i - 7; });
+    check_materialize_all_index_types<float>([](int i) { return i*0.5F; });
+    check_materialize_all_index_types<double>([](int i) { return i/3.0; });
+    check_materialize_all_index_types<std::int64_t>(
+      [](int i) { return std::int64_t(i) << 40; });
+    check_materialize_all_index_types<char>([](int i) { return char('a' + i%26); });
+    check_materialize_all_index_types<Record>(
+      [](int i) { return Record{i, i*1.5, {'a', 'b', 'c'}}; });
+    check_materialize_all_index_types<std::string>(
+      [](int i) { return std::to_string(i); });
+}
+
+TEST(IdxViews, MaterializeContainer)
+{
+    std::vector<double> A;
+    for (int i = 0; i < 12; ++i)
+        A.push_back(i*1.25);
+
+    auto X = discreture::combinations(A, 4);
+    std::vector<double> out(4*X.size());
+    auto last = X.materialize_into(out.data());
+    ASSERT_EQ(last, out.data() + out.size());
+
+    auto it = out.begin();
+    for (auto&& x : X)
+    {
+        for (auto a : x)
+        {
+            ASSERT_EQ(a, *it);
+            ++it;
+        }
+    }
+
+    // a batch from the middle
+    std::vector<double> batch(4*10);
+    X.materialize_into(batch.data(), 100, 10);
+    ASSERT_TRUE(std::equal(batch.begin(), batch.end(), out.begin() + 400));
+}
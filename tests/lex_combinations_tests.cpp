@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <iostream>
+#include <numeric>
 
 #include "Discreture/LexCombinations.hpp"
 #include "common_tests.hpp"
@@ -192,3 +193,67 @@ TEST(LexCombinations, PartitionPoint)
     ASSERT_EQ(rcomb[1], 31);
     ASSERT_EQ(rcomb.back(), 59);
 }
+
+TEST(LexCombinations, RandomIsUniform)
+{
+    test_random_is_uniform(lex_combinations(7, 3));
+    test_random_is_uniform(lex_combinations(5, 5));
+}
+
+TEST(LexCombinations, Aggregated)
+{
+    for (int n = 0; n < 12; ++n)
+    {
+        std::vector<long> w;
+        for (int i = 0; i < n; ++i)
+            w.push_back((i*37)%11 - 4);
+
+        for (int k = 0; k <= n; ++k)
+        {
+            auto X = lex_combinations(n, k);
+            auto A = X.aggregated(0L,
+                                  [&w](long& s, int x) { s += w[x]; },
+                                  [&w](long& s, int x) { s -= w[x]; });
+            ASSERT_EQ(A.size(), X.size());
+
+            auto it = X.begin();
+            for (auto&& a : A)
+            {
+                ASSERT_EQ(a.elements, *it);
+                long sum = 0;
+                for (auto x : a.elements)
+                    sum += w[x];
+                ASSERT_EQ(a.aggregate, sum);
+                ++it;
+            }
+            ASSERT_EQ(it, X.end());
+        }
+    }
+}
+
+TEST(LexCombinations, FindAllStateful)
+{
+    for (int n = 0; n < 12; ++n)
+    {
+        for (int k = 0; k <= n; ++k)
+        {
+            int bound = n + k;
+            auto push = [bound](int sum, int x) -> boost::optional<int> {
+                if (sum + x > bound)
+                    return boost::none;
+                return sum + x;
+            };
+
+            auto X = lex_combinations(n, k);
+            std::vector<decltype(X)::combination> expected;
+            for (auto&& x : X)
+                if (std::accumulate(x.begin(), x.end(), 0) <= bound)
+                    expected.push_back(x);
+
+            std::vector<decltype(X)::combination> found;
+            for (auto&& t : X.find_all(0, push))
+                found.push_back(t);
+            ASSERT_EQ(found, expected);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include "Discreture/Modular.hpp"
+#include "Discreture/Probability.hpp"
+#include "Discreture/Sequences.hpp"
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace discreture;
+
+TEST(Modular, Reducers)
+{
+    random::xoshiro256ss engine(3);
+    for (std::uint32_t m : {1U, 2U, 3U, 1000U, 998244353U, 1000000007U, 4294967295U})
+    {
+        Barrett B(m);
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::uint64_t x = engine();
+            ASSERT_EQ(B.reduce(x), x%m);
+            std::uint32_t a = engine()%m, b = engine()%m;
+            ASSERT_EQ(B.mul(a, b), std::uint64_t(a)*b%m);
+            ASSERT_EQ(B.add(a, b), (std::uint64_t(a) + b)%m);
+            ASSERT_EQ(B.sub(a, b), (std::uint64_t(a) + m - b)%m);
+        }
+    }
+
+    for (std::uint32_t n : {1U, 3U, 97U, 998244353U, 2147483647U})
+    {
+        Montgomery M(n);
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::uint32_t a = engine()%n, b = engine()%n;
+            ASSERT_EQ(M.from(M.to(a)), a);
+            ASSERT_EQ(M.from(M.mul(M.to(a), M.to(b))), std::uint64_t(a)*b%n);
+            ASSERT_EQ(M.from(M.add(M.to(a), M.to(b))), (std::uint64_t(a) + b)%n);
+            ASSERT_EQ(M.from(M.pow(M.to(a), 5)), pow_mod(a, 5, n));
+        }
+    }
+
+    ASSERT_EQ(pow_mod(2, 10, 1000), 24);
+    ASSERT_EQ(inverse_mod(3, 7), 5);
+    ASSERT_EQ(inverse_mod(7, 720), 103);
+    auto inv = inverses_mod(1000, 998244353);
+    for (std::uint64_t i = 1; i <= 1000; ++i)
+        ASSERT_EQ(i*inv[i]%998244353, 1);
+}
+
+TEST(Modular, Binomials)
+{
+    const std::uint32_t p = 998244353;
+    BinomialMod C(200, p);
+    for (int n = 0; n <= 66; ++n)
+        for (int k = 0; k <= n + 1; ++k)
+            ASSERT_EQ(C(n, k), binomial<llint>(n, k)%p) << n << " " << k;
+    ASSERT_NO_THROW(C(200, 100));
+    ASSERT_THROW(C(201, 100), std::out_of_range);
+
+    // Lucas
+    for (std::uint32_t q : {2U, 3U, 7U, 11U})
+    {
+        BinomialMod L(q - 1, q);
+        for (int n = 0; n <= 66; ++n)
+            for (int k = 0; k <= n; ++k)
+                ASSERT_EQ(L(n, k), binomial<llint>(n, k)%q);
+    }
+
+    // Prime powers and general moduli
+    for (std::uint32_t m : {4U, 8U, 9U, 25U, 27U, 32U, 720U, 1000U, 1U})
+    {
+        for (int n = 0; n <= 66; ++n)
+            for (int k = 0; k <= n; ++k)
+                ASSERT_EQ(binomial_mod(n, k, m), binomial<llint>(n, k)%m) << n << " " << k << " " << m;
+    }
+
+    // binomial(10^18, 10^9) mod 7 by Lucas on digits, against the prime power
+    // version with e = 1.
+    BinomialMod L7(6, 7);
+    BinomialModPrimePower P7(7, 1);
+    std::uint64_t n = 1000000000000000000ULL;
+    for (std::uint64_t k : {1ULL, 12345ULL, 1000000000ULL})
+        ASSERT_EQ(L7(n, k), P7(n, k));
+}
+
+TEST(Modular, Sequences)
+{
+    const std::uint32_t p = 998244353;
+    auto C = catalan_mod_table(30, p);
+    auto M = motzkin_mod_table(30, p);
+    for (int n = 0; n <= 30; ++n)
+    {
+        ASSERT_EQ(C[n], catalan<llint>(n)%p);
+        ASSERT_EQ(M[n], motzkin<llint>(n)%p);
+    }
+
+    auto S2 = stirling_partition_mod_table(20, 1000);
+    auto S1 = stirling_cycle_mod_table(20, 1000);
+    for (int n = 0; n <= 20; ++n)
+    {
+        ASSERT_EQ(S2[n].size(), n + 1);
+        for (int k = 0; k <= n; ++k)
+        {
+            ASSERT_EQ(S2[n][k], stirling_partition_number<llint>(n, k)%1000);
+            ASSERT_EQ(S1[n][k], stirling_cycle_number<llint>(n, k)%1000);
+        }
+    }
+}
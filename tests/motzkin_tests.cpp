@@ -1,4 +1,5 @@
 #include "Discreture/Motzkin.hpp"
+#include "common_tests.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
 #include <set>
@@ -36,3 +37,9 @@ TEST(MotzkinPaths, ForwardIteration)
         }
     }
 }
+
+TEST(MotzkinPaths, RandomIsUniform)
+{
+    for (int n = 0; n < 7; ++n)
+        test_random_is_uniform(motzkin_paths(n));
+}
@@ -0,0 +1,92 @@
+#include "Discreture/MultiplicativeFunctions.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+using namespace discreture;
+
+TEST(MultiplicativeFunctions, SmallTables)
+{
+    const std::uint64_t N = 20000;
+    auto mu = mobius_table(N);
+    auto phi = totient_table(N, 3);
+    auto d = divisor_count_table(N);
+    auto sigma = divisor_sum_table(N, 2);
+
+    ASSERT_EQ(mu[0], 0);
+    ASSERT_EQ(phi[0], 0);
+    for (std::uint64_t n = 1; n <= N; ++n)
+    {
+        int m = 1;
+        std::uint64_t t = n, c = 1, s = 1;
+        for (auto pa : factorize(n))
+        {
+            m = (pa.a == 1) ? -m : 0;
+            std::uint64_t pk = 1, sum = 1;
+            for (int i = 0; i < pa.a; ++i)
+            {
+                pk *= pa.p;
+                sum += pk;
+            }
+            t = t/pa.p*(pa.p - 1);
+            c *= pa.a + 1;
+            s *= sum;
+        }
+        ASSERT_EQ(mu[n], m) << n;
+        ASSERT_EQ(phi[n], t) << n;
+        ASSERT_EQ(d[n], c) << n;
+        ASSERT_EQ(sigma[n], s) << n;
+    }
+}
+
+TEST(MultiplicativeFunctions, Ranges)
+{
+    const std::uint64_t lo = 1000000000000ULL;
+    const std::uint64_t len = 5000;
+    std::vector<std::int64_t> phi(len);
+    std::vector<std::int8_t> mu(len);
+    fill_totient(lo, lo + len, phi.data(), 4);
+    fill_mobius(lo, lo + len, mu.data());
+
+    for (std::uint64_t i = 0; i < len; ++i)
+    {
+        std::int64_t t = lo + i;
+        int m = 1;
+        for (auto pa : factorize(lo + i))
+        {
+            t = t/pa.p*(pa.p - 1);
+            m = (pa.a == 1) ? -m : 0;
+        }
+        ASSERT_EQ(phi[i], t);
+        ASSERT_EQ(mu[i], m);
+    }
+}
+
+TEST(MultiplicativeFunctions, MappedArray)
+{
+    const std::uint64_t N = 100000;
+    auto expected = mobius_table(N);
+
+    mapped_array<std::int8_t> A(N + 1);
+    fill_mobius(0, N + 1, A.data(), 2);
+    ASSERT_TRUE(std::equal(A.begin(), A.end(), expected.begin(), expected.end()));
+
+    std::string path = ::testing::TempDir() + "discreture_mobius.bin";
+    {
+        mapped_array<std::int8_t> F(path, N + 1);
+        fill_mobius(0, N + 1, F.data());
+    }
+    {
+        mapped_array<std::int8_t> F(path, N + 1); // keeps the contents
+        ASSERT_TRUE(std::equal(F.begin(), F.end(), expected.begin(), expected.end()));
+    }
+    {
+        mapped_array<std::int8_t> F(path, 10); // doesn't truncate the file
+    }
+    {
+        mapped_array<std::int8_t> F(path, N + 1);
+        ASSERT_TRUE(std::equal(F.begin(), F.end(), expected.begin(), expected.end()));
+    }
+    std::remove(path.c_str());
+}
@@ -1,8 +1,10 @@
 #include "Discreture/Multisets.hpp"
 #include "Discreture/Probability.hpp"
+#include "Discreture/Sequences.hpp"
 #include "common_tests.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
+#include <numeric>
 #include <set>
 
 using namespace std;
@@ -75,3 +77,84 @@ TEST(Multisets, PartitionPoint)
 
     ASSERT_EQ(t, correct);
 }
+
+TEST(Multisets, RandomIsUniform)
+{
+    test_random_is_uniform(multisets({2, 0, 1, 3}));
+    test_random_is_uniform(multisets(4, 2), 200);
+}
+
+TEST(Multisets, FixedSize)
+{
+    for (int n = 0; n < 9; ++n)
+    {
+        auto total = get_random_multiset(n);
+        int sum = std::accumulate(total.begin(), total.end(), 0);
+        multisets All(total);
+        for (int k = 0; k <= sum + 1; ++k)
+        {
+            // the same order as all of them, keeping those of size k
+            std::vector<multisets::multiset> expected;
+            for (auto&& x : All)
+            {
+                if (std::accumulate(x.begin(), x.end(), 0) == k)
+                    expected.push_back(x);
+            }
+
+            multisets X(total, k);
+            ASSERT_EQ(X.size(), expected.size());
+            ASSERT_EQ(multisets::count(total, k), X.size());
+            ASSERT_EQ(std::vector<multisets::multiset>(X.begin(), X.end()), expected);
+            test_container_full(X, [&total, k](const auto& x) {
+                check_multiset(x, total);
+                ASSERT_EQ(std::accumulate(x.begin(), x.end(), 0), k);
+            });
+            test_container_foreach(X);
+            for (int i = 0; i < X.size(); ++i)
+                ASSERT_EQ(X.get_index(X[i]), i);
+        }
+    }
+
+    // with total[i] >= k, these are the combinations with repetitions
+    multisets::multiset total(30, 4);
+    multisets Y(total, 4);
+    ASSERT_EQ(Y.size(), binomial(30 + 4 - 1, 4));
+    test_container_foreach(Y);
+    auto y = Y[12345];
+    ASSERT_EQ(Y.get_index(y), 12345);
+    ASSERT_EQ(*(Y.begin() + 12345), y);
+
+    test_random_is_uniform(multisets({2, 0, 1, 3}, 3));
+}
+
+TEST(Multisets, FixedSizeFromTheEnd)
+{
+    multisets X(multisets::multiset{2, 1, 3, 2}, 4);
+    const auto n = X.size();
+
+    // long jumps onto end() and back
+    auto it = X.begin() + 1;
+    it += n - 1;
+    ASSERT_EQ(it, X.end());
+    --it;
+    ASSERT_EQ(*it, X[n - 1]);
+
+    auto rit = X.rbegin() + 1;
+    rit += n - 1;
+    ASSERT_EQ(rit, X.rend());
+    --rit;
+    ASSERT_EQ(*rit, X[0]);
+
+    for (int m = 1; m <= n; ++m)
+    {
+        ASSERT_EQ(*(X.end() - m), X[n - m]);
+        ASSERT_EQ(*(X.rend() - m), X[m - 1]);
+    }
+
+    it = X.end();
+    --it;
+    ASSERT_EQ(*it, X[n - 1]);
+    rit = X.rend();
+    --rit;
+    ASSERT_EQ(*rit, X[0]);
+}
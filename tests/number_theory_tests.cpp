@@ -0,0 +1,116 @@
+#include "Discreture/NumberTheory.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace std;
+using namespace discreture;
+
+static bool naive_is_prime(std::uint64_t n)
+{
+    if (n < 2)
+        return false;
+    for (std::uint64_t d = 2; d*d <= n; ++d)
+        if (n%d == 0)
+            return false;
+    return true;
+}
+
+static std::uint64_t multiply_out(const factorization& F)
+{
+    std::uint64_t result = 1;
+    for (auto pa : F)
+    {
+        EXPECT_TRUE(is_prime(pa.p));
+        for (int i = 0; i < pa.a; ++i)
+            result *= pa.p;
+    }
+    return result;
+}
+
+TEST(NumberTheory, Sieve)
+{
+    auto P = primes_up_to(100000);
+    std::vector<std::uint64_t> expected;
+    for (std::uint64_t n = 0; n <= 100000; ++n)
+        if (naive_is_prime(n))
+            expected.push_back(n);
+    ASSERT_EQ(P, expected);
+    ASSERT_EQ(primes_up_to(100000, 3), expected);
+
+    for (std::uint64_t n = 0; n < 40; ++n)
+    {
+        auto Q = primes_up_to(n, 4);
+        std::vector<std::uint64_t> E;
+        for (std::uint64_t m = 0; m <= n; ++m)
+            if (naive_is_prime(m))
+                E.push_back(m);
+        ASSERT_EQ(Q, E);
+    }
+
+    std::uint64_t lo = 1000000000000ULL;
+    auto R = primes_in_range(lo, lo + 20000, 2);
+    std::vector<std::uint64_t> S;
+    for_each_prime(lo, lo + 20000, [&S](std::uint64_t p) { S.push_back(p); });
+    ASSERT_EQ(R, S);
+    std::size_t j = 0;
+    for (std::uint64_t n = lo; n < lo + 20000; ++n)
+    {
+        if (is_prime(n))
+        {
+            ASSERT_LT(j, R.size());
+            ASSERT_EQ(R[j], n);
+            ++j;
+        }
+    }
+    ASSERT_EQ(j, R.size());
+}
+
+TEST(NumberTheory, IsPrime)
+{
+    for (std::uint64_t n = 0; n < 20000; ++n)
+        ASSERT_EQ(is_prime(n), naive_is_prime(n)) << n;
+
+    ASSERT_TRUE(is_prime(2305843009213693951ULL));  // 2^61 - 1
+    ASSERT_TRUE(is_prime(18446744073709551557ULL)); // largest below 2^64
+    ASSERT_FALSE(is_prime(3215031751ULL));          // strong pseudoprime to 2,3,5,7
+    ASSERT_FALSE(is_prime(3825123056546413051ULL)); // to all bases up to 37
+    ASSERT_FALSE(is_prime(1000000007ULL*998244353ULL));
+}
+
+TEST(NumberTheory, Factorize)
+{
+    for (std::uint64_t n = 1; n < 5000; ++n)
+        ASSERT_EQ(multiply_out(factorize(n)), n);
+
+    factorization F = factorize(18446744073709551615ULL); // 2^64 - 1
+    factorization expected = {{3, 1}, {5, 1}, {17, 1}, {257, 1}, {641, 1}, {65537, 1}, {6700417, 1}};
+    ASSERT_EQ(F, expected);
+
+    expected = {{998244353, 1}, {1000000007, 1}};
+    ASSERT_EQ(factorize(1000000007ULL*998244353ULL), expected);
+
+    expected = {{4294967291ULL, 2}}; // largest prime below 2^32, squared
+    ASSERT_EQ(factorize(4294967291ULL*4294967291ULL), expected);
+
+    ASSERT_TRUE(factorize(0).empty());
+    ASSERT_TRUE(factorize(1).empty());
+}
+
+TEST(NumberTheory, FactorizeRange)
+{
+    std::uint64_t lo = 1000000000ULL - 3000;
+    auto A = factorize_range(lo, lo + 6000);
+    auto B = factorize_range(lo, lo + 6000, 3);
+    ASSERT_EQ(A.size(), 6000);
+    for (std::uint64_t i = 0; i < A.size(); ++i)
+    {
+        ASSERT_EQ(A[i], factorize(lo + i));
+        ASSERT_EQ(B[i], A[i]);
+    }
+
+    auto C = factorize_range(0, 100);
+    ASSERT_TRUE(C[0].empty());
+    ASSERT_TRUE(C[1].empty());
+    for (std::uint64_t n = 2; n < 100; ++n)
+        ASSERT_EQ(C[n], factorize(n));
+}
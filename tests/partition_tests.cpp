@@ -1,6 +1,10 @@
+#include "Discreture/MultiplicityPartitions.hpp"
 #include "Discreture/Partitions.hpp"
+#include "Discreture/RestrictedPartitions.hpp"
+#include "common_tests.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <set>
 
@@ -123,3 +127,136 @@ TEST(Partitions, WithRangeNumParts)
         }
     }
 }
+
+TEST(Partitions, RandomIsUniform)
+{
+    for (int n = 0; n < 9; ++n)
+        test_random_is_uniform(partitions(n), 200);
+
+    test_random_is_uniform(partitions(12, 4));
+    test_random_is_uniform(partitions(12, 3, 5), 200);
+}
+
+TEST(Partitions, RandomWithHugePartitionNumbers)
+{
+    // p(600,k) doesn't fit in an llint for these k. Given that, the number of
+    // parts is 22, 23, 24 or 25 with probability 0.0844, 0.1579, 0.2809 and
+    // 0.4768.
+    partitions X(600, 22, 25);
+    std::mt19937_64 engine(3);
+    const int num_samples = 2000;
+    std::vector<int> times(26, 0);
+    for (int i = 0; i < num_samples; ++i)
+    {
+        auto x = X.random(engine);
+        check_partition(x, 600);
+        ASSERT_GE(x.size(), 22);
+        ASSERT_LE(x.size(), 25);
+        ++times[x.size()];
+    }
+
+    EXPECT_NEAR(times[22]/double(num_samples), 0.0844, 0.03);
+    EXPECT_NEAR(times[23]/double(num_samples), 0.1579, 0.04);
+    EXPECT_NEAR(times[24]/double(num_samples), 0.2809, 0.04);
+    EXPECT_NEAR(times[25]/double(num_samples), 0.4768, 0.04);
+}
+
+TEST(Partitions, MultiplicityForm)
+{
+    for (int n = 0; n < 25; ++n)
+    {
+        multiplicity_partitions X(n);
+        ASSERT_EQ(X.size(), partitions(n).size());
+
+        // reverse lexicographic order of the lists of parts
+        std::vector<partitions::partition> P;
+        for (auto it = X.begin(); it != X.end(); ++it)
+        {
+            auto x = it.parts();
+            check_partition(x, n);
+            ASSERT_EQ(multiplicity_partitions::to_multiplicities(x), *it);
+            for (size_t i = 1; i < it->size(); ++i)
+                ASSERT_GT((*it)[i - 1].part, (*it)[i].part);
+            P.push_back(x);
+        }
+        ASSERT_EQ(P.size(), X.size());
+        ASSERT_TRUE(std::is_sorted(P.rbegin(), P.rend()));
+        ASSERT_EQ(std::adjacent_find(P.begin(), P.end()), P.end());
+
+        size_t i = 0;
+        X.for_each([&](const multiplicity_partitions::multiplicity_partition& x) {
+            ASSERT_EQ(multiplicity_partitions::to_parts(x), P[i]);
+            ++i;
+        });
+        ASSERT_EQ(i, P.size());
+
+        i = 0;
+        X.for_each_parts([&](const multiplicity_partitions::partition& x) {
+            ASSERT_EQ(x, P[i]);
+            ++i;
+        });
+        ASSERT_EQ(i, P.size());
+    }
+}
+
+TEST(Partitions, Restricted)
+{
+    auto check = [](const restricted_partitions& X, auto allowed) {
+        int n = X.get_n();
+        std::vector<partitions::partition> expected;
+        for (auto& x : multiplicity_partitions(n))
+            if (allowed(x))
+                expected.push_back(multiplicity_partitions::to_parts(x));
+
+        ASSERT_EQ(X.size(), expected.size());
+        std::vector<partitions::partition> P(X.begin(), X.end());
+        ASSERT_EQ(P, expected);
+
+        size_t i = 0;
+        X.for_each([&](const partitions::partition& x) {
+            ASSERT_EQ(x, expected[i]);
+            ++i;
+        });
+        ASSERT_EQ(i, expected.size());
+    };
+
+    for (int n = 0; n < 22; ++n)
+    {
+        check(distinct_partitions(n), [](auto& x) {
+            return std::all_of(x.begin(), x.end(), [](auto& b) { return b.multiplicity == 1; });
+        });
+
+        for (int m : {1, 2, 3, 7, 30})
+        {
+            check(partitions_with_max_part(n, m),
+                  [m](auto& x) { return x.empty() || x[0].part <= m; });
+        }
+
+        std::vector<int> S = {3, 5, 8, 5, 0, -2, 11};
+        auto in_S = [](int a) { return a == 3 || a == 5 || a == 8 || a == 11; };
+        check(partitions_with_parts(n, S), [&](auto& x) {
+            return std::all_of(x.begin(), x.end(), [&](auto& b) { return in_S(b.part); });
+        });
+        check(partitions_with_parts(n, S, true), [&](auto& x) {
+            return std::all_of(x.begin(), x.end(), [&](auto& b) {
+                return in_S(b.part) && b.multiplicity == 1;
+            });
+        });
+    }
+
+    // far fewer than p(200) ~ 4*10^12
+    ASSERT_EQ(distinct_partitions(200).size(), 487067746);
+    ASSERT_EQ(partitions_with_parts(200, {1, 5, 10, 25, 50, 100}).size(), 2728);
+
+    // the largest ones that fit, and saturated ones
+    const auto saturated = std::numeric_limits<restricted_partitions::size_type>::max();
+    ASSERT_EQ(partitions_with_max_part(400, 400).size(), 6727090051741041926LL);
+    ASSERT_EQ(partitions_with_max_part(600, 600).size(), saturated);
+    ASSERT_EQ(distinct_partitions(300).size(), 114872472064LL);
+    auto D = distinct_partitions(1000);
+    ASSERT_EQ(D.size(), saturated);
+    auto it = D.begin();
+    ASSERT_EQ(*it, partitions::partition({1000}));
+    ++it;
+    ASSERT_EQ(*it, partitions::partition({999, 1}));
+}
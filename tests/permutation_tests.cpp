@@ -1,7 +1,10 @@
+#include "Discreture/MultisetPermutations.hpp"
 #include "Discreture/Permutations.hpp"
 #include "common_tests.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
+#include <set>
+#include <string>
 
 using namespace std;
 using namespace discreture;
@@ -68,3 +71,100 @@ TEST(Permutations, PartitionPoint)
     ASSERT_TRUE(
       std::is_sorted(rperm.begin() + 1, rperm.end(), std::greater<int>()));
 }
+
+TEST(Permutations, RandomIsUniform)
+{
+    test_random_is_uniform(permutations(4));
+    test_random_is_uniform(permutations(1));
+}
+
+TEST(Permutations, Multiset)
+{
+    using multiset_permutations_type = MultisetPermutations<int>;
+    std::vector<std::vector<int>> all_counts = {
+      {}, {3}, {2, 1}, {1, 1, 1}, {2, 2}, {1, 0, 2}, {3, 1, 2}, {2, 2, 2, 1}};
+    for (auto& counts : all_counts)
+    {
+        multiset_permutations_type X(counts);
+
+        // every distinct arrangement, by brute force
+        std::vector<int> word;
+        for (int i = 0; i < int(counts.size()); ++i)
+            word.insert(word.end(), counts[i], i);
+        std::vector<std::vector<int>> expected;
+        do
+        {
+            expected.push_back(word);
+        } while (std::next_permutation(word.begin(), word.end()));
+
+        ASSERT_EQ(X.size(), expected.size());
+        ASSERT_EQ(std::vector<std::vector<int>>(X.begin(), X.end()), expected);
+
+        test_container_full(X, [&X](const auto& x) { ASSERT_EQ(X[X.get_index(x)], x); });
+        test_container_foreach(X);
+        for (int i = 0; i < X.size(); ++i)
+            ASSERT_EQ(X.get_index(X[i]), i);
+    }
+
+    // 30!/(10! 10! 10!) doesn't fit in 32 bits
+    multiset_permutations_type Y({10, 10, 10});
+    ASSERT_EQ(Y.size(), 5550996791340LL);
+    auto y = Y[4321234567LL];
+    ASSERT_EQ(Y.get_index(y), 4321234567LL);
+    ASSERT_EQ(*(Y.begin() + 4321234567LL), y);
+
+    test_random_is_uniform(multiset_permutations_type({2, 1, 1}));
+}
+
+TEST(Permutations, MultisetFromTheEnd)
+{
+    MultisetPermutations<int> X({2, 1, 2});
+    const auto n = X.size();
+    ASSERT_EQ(n, 30);
+
+    // long jumps (at least the length of a permutation) onto end() and back
+    for (int m : {5, 6, 12, 30})
+    {
+        ASSERT_EQ(*(X.end() - m), X[n - m]);
+        ASSERT_EQ(*(X.rend() - m), X[m - 1]);
+    }
+
+    auto it = X.begin() + n;
+    ASSERT_EQ(it, X.end());
+    --it;
+    ASSERT_EQ(*it, X[n - 1]);
+
+    auto rit = X.rbegin() + n;
+    ASSERT_EQ(rit, X.rend());
+    --rit;
+    ASSERT_EQ(*rit, X[0]);
+
+    it = X.end();
+    --it;
+    ASSERT_EQ(*it, X[n - 1]);
+    rit = X.rend();
+    --rit;
+    ASSERT_EQ(*rit, X[0]);
+}
+
+TEST(Permutations, MultisetOfObjects)
+{
+    std::string word = "banana";
+    auto X = multiset_permutations(word);
+    ASSERT_EQ(X.size(), 60); // 6!/(3! 2! 1!)
+
+    std::vector<std::string> words;
+    for (auto&& x : X)
+        words.emplace_back(x.begin(), x.end());
+    ASSERT_EQ(words.front(), "aaabnn");
+    ASSERT_EQ(words.back(), "nnbaaa");
+    ASSERT_TRUE(std::is_sorted(words.begin(), words.end()));
+    ASSERT_EQ(std::set<std::string>(words.begin(), words.end()).size(), 60);
+
+    std::vector<std::string> A = {"b", "a", "b"};
+    auto Y = multiset_permutations(A);
+    ASSERT_EQ(Y.size(), 3);
+    auto third = Y[2];
+    ASSERT_EQ(std::vector<std::string>(third.begin(), third.end()),
+              (std::vector<std::string>{"b", "b", "a"}));
+}
@@ -0,0 +1,183 @@
+#include "Discreture/PowerSeries.hpp"
+#include "Discreture/Probability.hpp"
+#include "Discreture/Sequences.hpp"
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace discreture;
+
+namespace
+{
+// number of partitions (or distinct partitions, or compositions) of
+// 0, ..., N with parts in the set, by dynamic programming
+vector<uint32_t> count_naive(uint32_t N, const vector<uint32_t>& parts, int kind, uint32_t m)
+{
+    vector<uint64_t> C(N + 1, 0);
+    C[0] = 1;
+    if (kind == 2) // compositions
+    {
+        for (uint32_t n = 1; n <= N; ++n)
+            for (auto s : parts)
+                if (s <= n)
+                    C[n] = (C[n] + C[n - s])%m;
+    }
+    else
+    {
+        for (auto s : parts)
+        {
+            if (kind == 0)
+                for (uint32_t n = s; n <= N; ++n)
+                    C[n] = (C[n] + C[n - s])%m;
+            else
+                for (uint32_t n = N; n >= s; --n)
+                    C[n] = (C[n] + C[n - s])%m;
+        }
+    }
+    return vector<uint32_t>(C.begin(), C.end());
+}
+} // namespace
+
+TEST(PowerSeries, Multiply)
+{
+    random::xoshiro256ss engine(7);
+    PowerSeriesMod P;
+    const uint32_t p = P.modulus();
+    ASSERT_EQ(P.max_length(), 1 << 23);
+
+    for (size_t na : {1, 5, 33, 100, 1000})
+    {
+        for (size_t nb : {1, 40, 777})
+        {
+            vector<uint32_t> a(na), b(nb);
+            for (auto& x : a)
+                x = engine()%p;
+            for (auto& x : b)
+                x = engine()%p;
+
+            vector<uint64_t> naive(na + nb - 1, 0);
+            for (size_t i = 0; i < na; ++i)
+                for (size_t j = 0; j < nb; ++j)
+                    naive[i + j] = (naive[i + j] + uint64_t(a[i])*b[j])%p;
+
+            auto c = P.multiply(a, b);
+            ASSERT_EQ(c.size(), na + nb - 1);
+            for (size_t i = 0; i < c.size(); ++i)
+                ASSERT_EQ(c[i], naive[i]);
+
+            auto c10 = P.multiply(a, b, 10);
+            naive.resize(10);
+            ASSERT_TRUE(std::equal(c10.begin(), c10.end(), naive.begin()));
+        }
+    }
+
+    // any modulus by CRT
+    for (uint32_t m : {2U, 1000U, 1000000007U, 2147483647U})
+    {
+        vector<uint32_t> a(300), b(500);
+        for (auto& x : a)
+            x = engine()%m;
+        for (auto& x : b)
+            x = engine()%m;
+        auto c = multiply_mod(a, b, m, 799);
+        for (size_t k = 0; k < c.size(); ++k)
+        {
+            uint64_t naive = 0;
+            for (size_t i = 0; i < a.size() && i <= k; ++i)
+                if (k - i < b.size())
+                    naive = (naive + uint64_t(a[i])*b[k - i])%m;
+            ASSERT_EQ(c[k], naive);
+        }
+    }
+}
+
+TEST(PowerSeries, InverseLogExp)
+{
+    random::xoshiro256ss engine(11);
+    PowerSeriesMod P(469762049);
+    const uint32_t p = P.modulus();
+
+    vector<uint32_t> a(1000);
+    for (auto& x : a)
+        x = engine()%p;
+    a[0] = 1;
+
+    auto ia = P.inverse(a, 1500);
+    auto one = P.multiply(a, ia, 1500);
+    ASSERT_EQ(one[0], 1);
+    for (size_t i = 1; i < one.size(); ++i)
+        ASSERT_EQ(one[i], 0);
+
+    auto la = P.log(a, 1000);
+    ASSERT_EQ(la[0], 0);
+    ASSERT_EQ(P.exp(la, 1000), a);
+}
+
+TEST(PowerSeries, RestrictedPartitions)
+{
+    const uint32_t p = 998244353;
+    const uint32_t N = 2000;
+
+    auto part = partition_mod_table(N, p);
+    for (int n = 0; n <= 400; ++n)
+        ASSERT_EQ(part[n], partition_number<llint>(n)%p);
+
+    vector<uint32_t> all(N);
+    for (uint32_t i = 0; i < N; ++i)
+        all[i] = i + 1;
+    ASSERT_EQ(part, count_naive(N, all, 0, p));
+    ASSERT_EQ(distinct_partition_mod_table(N, p), count_naive(N, all, 1, p));
+
+    vector<uint32_t> S = {3, 5, 7, 5, 12, 100, 5000};
+    vector<uint32_t> S_set = {3, 5, 7, 12, 100};
+    ASSERT_EQ(partition_with_parts_mod_table(N, S, p), count_naive(N, S_set, 0, p));
+    ASSERT_EQ(distinct_partition_with_parts_mod_table(N, S, p), count_naive(N, S_set, 1, p));
+    ASSERT_EQ(composition_with_parts_mod_table(N, S_set, p), count_naive(N, S_set, 2, p));
+
+    auto at_most = partition_at_most_mod_table(60, 7, p);
+    for (int n = 0; n <= 60; ++n)
+    {
+        llint total = 0;
+        for (int k = 0; k <= 7; ++k)
+            total += partition_number<llint>(n, k);
+        ASSERT_EQ(at_most[n], total%p);
+    }
+}
+
+TEST(PowerSeries, BellAndStirlingRows)
+{
+    const uint32_t p = 998244353;
+
+    auto bell = bell_mod_table(300, p);
+    auto S2 = stirling_partition_mod_table(300, p);
+    for (int n = 0; n <= 300; ++n)
+    {
+        uint64_t total = 0;
+        for (auto x : S2[n])
+            total += x;
+        ASSERT_EQ(bell[n], total%p);
+    }
+
+    auto S1 = stirling_cycle_mod_table(300, p);
+    for (uint32_t n : {0U, 1U, 2U, 17U, 100U, 300U})
+    {
+        ASSERT_EQ(stirling_partition_row_mod(n, p), S2[n]);
+        ASSERT_EQ(stirling_cycle_row_mod(n, p), S1[n]);
+    }
+
+    // large rows: sum_k c(n,k) = n!, sum_k S(n,k) = B_n
+    const uint32_t n = 100000;
+    auto c = stirling_cycle_row_mod(n, p);
+    ASSERT_EQ(c.size(), n + 1);
+    uint64_t total = 0, fact = 1;
+    for (auto x : c)
+        total += x;
+    for (uint64_t i = 1; i <= n; ++i)
+        fact = fact*i%p;
+    ASSERT_EQ(total%p, fact);
+
+    auto s = stirling_partition_row_mod(n, p);
+    total = 0;
+    for (auto x : s)
+        total += x;
+    ASSERT_EQ(total%p, bell_mod_table(n, p)[n]);
+}
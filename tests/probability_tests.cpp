@@ -0,0 +1,100 @@
+#include "Discreture/Probability.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace discreture;
+
+TEST(Probability, EngineIsReproducible)
+{
+    random::xoshiro256ss A(42);
+    random::xoshiro256ss B(42);
+    random::xoshiro256ss C(43);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto a = A();
+        ASSERT_EQ(a, B());
+        ASSERT_NE(a, C());
+    }
+
+    A.discard(10);
+    for (int i = 0; i < 10; ++i)
+        B();
+    ASSERT_EQ(A, B);
+}
+
+TEST(Probability, Streams)
+{
+    random::xoshiro256ss S0(7, 0);
+    random::xoshiro256ss S1(7, 1);
+    random::xoshiro256ss S1again(7, 1);
+    ASSERT_NE(S0, S1);
+    ASSERT_EQ(S1, S1again);
+
+    // pairs that xor-ing the seed with a hash of the stream would confuse
+    std::uint64_t x = 0, y = 1;
+    std::uint64_t h0 = random::splitmix64(x), h1 = random::splitmix64(y);
+    ASSERT_NE(random::xoshiro256ss(h1, 0), random::xoshiro256ss(h0, 1));
+    ASSERT_NE(random::xoshiro256ss(0, 1), random::xoshiro256ss(1, 0));
+
+    random::xoshiro256ss A(5);
+    auto first = A.split();
+    auto second = A.split();
+    ASSERT_NE(first, second);
+    ASSERT_NE(second, A);
+
+    random::xoshiro256ss B(5);
+    ASSERT_EQ(first, B);
+    B.jump();
+    ASSERT_EQ(second, B);
+}
+
+TEST(Probability, ThreadLocalEngines)
+{
+    random::seed_random_engine(1234);
+    auto expected = random::xoshiro256ss(1234)();
+
+    random::xoshiro256ss::result_type other_thread_first = 0;
+    std::thread t([&other_thread_first]() {
+        // seeding in another thread doesn't affect this one's engine
+        random::seed_random_engine(1234);
+        other_thread_first = random::random_engine()();
+    });
+    t.join();
+
+    ASSERT_EQ(other_thread_first, expected);
+    ASSERT_EQ(random::random_engine()(), expected);
+}
+
+TEST(Probability, Fill)
+{
+    random::xoshiro256ss engine(99);
+
+    std::vector<int> A(10000);
+    random::fill_random_int(A.begin(), A.end(), -3, 4, engine);
+    std::vector<int> count(7, 0);
+    for (auto a : A)
+    {
+        ASSERT_GE(a, -3);
+        ASSERT_LT(a, 4);
+        ++count[a + 3];
+    }
+    for (auto c : count)
+        ASSERT_GT(c, 1000);
+
+    std::vector<double> R(1000);
+    random::fill_random_real(R.begin(), R.end(), 2.0, 3.0);
+    for (auto r : R)
+    {
+        ASSERT_GE(r, 2.0);
+        ASSERT_LT(r, 3.0);
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        int x = random::random_int(5, 6);
+        ASSERT_EQ(x, 5);
+    }
+}
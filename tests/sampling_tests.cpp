@@ -0,0 +1,173 @@
+#include "Discreture/Combinations.hpp"
+#include "Discreture/Parallel.hpp"
+#include "Discreture/Permutations.hpp"
+#include "Discreture/Sampling.hpp"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <random>
+#include <set>
+
+using namespace std;
+using namespace discreture;
+
+template <class Container>
+void check_strided(const Container& X, std::ptrdiff_t step, std::ptrdiff_t offset)
+{
+    auto S = strided(X, step, offset);
+
+    std::ptrdiff_t i = offset;
+    for (auto&& x : S)
+    {
+        ASSERT_LT(i, X.size());
+        ASSERT_EQ(x, X[i]);
+        i += step;
+    }
+    ASSERT_GE(i, X.size());
+
+    std::ptrdiff_t expected_size = 0;
+    for (std::ptrdiff_t j = offset; j < std::ptrdiff_t(X.size()); j += step)
+        ++expected_size;
+    ASSERT_EQ(S.size(), expected_size);
+    ASSERT_EQ(S.end() - S.begin(), expected_size);
+
+    // random access, backwards
+    for (std::ptrdiff_t j = S.size() - 1; j >= 0; --j)
+        ASSERT_EQ(*(S.begin() + j), X[offset + j*step]);
+}
+
+TEST(Sampling, Strided)
+{
+    auto X = combinations(16, 7);
+    for (std::ptrdiff_t step : {1, 2, 7, 50, 1000, 20000})
+        for (std::ptrdiff_t offset : {0, 1, 13, 11439, 11440, 50000})
+            check_strided(X, step, offset);
+
+    check_strided(permutations(6), 5, 2);
+
+    std::vector<int> A = {1, 4, 3, 6, 5, 4, 8};
+    check_strided(A, 2, 1);
+    check_strided(A, 3, 0);
+}
+
+namespace
+{
+struct Copied
+{
+    static int num_copies;
+    int value;
+
+    Copied(int v) : value(v) {}
+    Copied(const Copied& other) : value(other.value) { ++num_copies; }
+    Copied(Copied&& other) = default;
+};
+
+int Copied::num_copies = 0;
+} // namespace
+
+TEST(Sampling, OwnsRvalues)
+{
+    auto make = []() {
+        std::vector<Copied> V;
+        for (int i = 0; i < 10; ++i)
+            V.emplace_back(i);
+        return V;
+    };
+
+    // Temporaries are moved in, not copied
+    Copied::num_copies = 0;
+    auto T = strided(make(), 3, 1);
+    auto S = sample(make(), 4, 7);
+    ASSERT_EQ(Copied::num_copies, 0);
+
+    std::vector<int> strided_values;
+    for (auto&& x : T)
+        strided_values.push_back(x.value);
+    ASSERT_EQ(strided_values, (std::vector<int>{1, 4, 7}));
+
+    ASSERT_EQ(S.size(), 4);
+    auto I = S.indices();
+    int i = 0;
+    for (auto&& x : S)
+        ASSERT_EQ(x.value, I[i++]);
+}
+
+TEST(Sampling, RandomSortedIndices)
+{
+    std::mt19937_64 engine(42);
+    for (std::ptrdiff_t n : {0, 1, 10, 1000})
+    {
+        for (std::ptrdiff_t m : {0, 1, 5, 10, 100, 1000, 2000})
+        {
+            auto I = random_sorted_indices(n, m, engine);
+            ASSERT_EQ(I.size(), std::min(n, m));
+            ASSERT_TRUE(std::is_sorted(I.begin(), I.end()));
+            ASSERT_EQ(std::set<std::ptrdiff_t>(I.begin(), I.end()).size(),
+                      I.size());
+            for (auto i : I)
+            {
+                ASSERT_GE(i, 0);
+                ASSERT_LT(i, n);
+            }
+        }
+    }
+}
+
+TEST(Sampling, SampleIsReproducible)
+{
+    auto X = combinations(20, 10);
+    auto S = sample(X, 500, 12345);
+    ASSERT_EQ(S.size(), 500);
+
+    auto it = S.indices().begin();
+    for (auto&& x : S)
+    {
+        ASSERT_EQ(x, X[*it]);
+        ++it;
+    }
+
+    auto T = sample(X, 500, 12345);
+    ASSERT_EQ(S.indices(), T.indices());
+
+    auto U = sample(X, 500, 54321);
+    ASSERT_NE(S.indices(), U.indices());
+}
+
+TEST(Sampling, SampleIsRoughlyUniform)
+{
+    // Each of the 10 elements should be chosen about m/n times.
+    std::vector<int> A(10, 0);
+    std::vector<int> count(10, 0);
+    int num_trials = 2000;
+    for (int seed = 0; seed < num_trials; ++seed)
+    {
+        auto S = sample(A, 3, seed);
+        for (auto i : S.indices())
+            ++count[i];
+    }
+
+    for (auto c : count)
+    {
+        ASSERT_GT(c, num_trials*3/10 - 150);
+        ASSERT_LT(c, num_trials*3/10 + 150);
+    }
+}
+
+TEST(Sampling, ParallelSample)
+{
+    auto X = combinations(22, 11);
+    auto S = sample(X, 3000, 7);
+
+    std::mutex m;
+    std::set<Combinations<int>::combination> seen;
+    parallel_for_each(S.begin(),
+                      S.end(),
+                      [&](const auto& x) {
+                          std::lock_guard<std::mutex> lock(m);
+                          seen.insert(x);
+                      },
+                      4);
+
+    ASSERT_EQ(seen.size(), 3000);
+    for (auto&& x : S)
+        ASSERT_EQ(seen.count(x), 1);
+}
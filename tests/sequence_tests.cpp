@@ -1,6 +1,7 @@
 #include "Discreture/Probability.hpp"
 #include "Discreture/Sequences.hpp"
 #include <gtest/gtest.h>
+#include <limits>
 #include <iostream>
 #include <set>
 
@@ -137,3 +138,32 @@ TEST(Sequences, StirlingPartition)
     ASSERT_EQ(stirling_partition_number(8, 4), 1701);
     ASSERT_EQ(stirling_partition_number(10, 5), 42525);
 }
+
+TEST(Sequences, TriangularTables)
+{
+    // past the compile time rows, and in no particular order
+    for (llint n : {200, 70, 0, 150, 63, 64, 65, 1})
+    {
+        llint total = 0;
+        for (llint k = 0; k <= n; ++k)
+            total += partition_number(n, k);
+        ASSERT_EQ(total, partition_number(n));
+    }
+    ASSERT_EQ(partition_number(200, 3), 3333); // round(200^2/12)
+
+    for (llint n = 1; n < 26; ++n)
+    {
+        ASSERT_EQ(stirling_partition_number(n, 1), 1);
+        ASSERT_EQ(stirling_partition_number(n, n - 1), n*(n - 1)/2);
+        ASSERT_EQ(stirling_partition_number(n, n + 1), 0);
+    }
+    for (llint n = 1; n < 21; ++n)
+        ASSERT_EQ(stirling_cycle_number(n, n - 1), n*(n - 1)/2);
+    ASSERT_EQ(stirling_cycle_number(21, 1), 2432902008176640000LL); // 20!
+
+    // Past what fits in an llint, the tables saturate instead of overflowing
+    const llint too_big = std::numeric_limits<llint>::max();
+    ASSERT_EQ(stirling_partition_number(60, 30), too_big);
+    ASSERT_EQ(stirling_cycle_number(30, 5), too_big);
+    ASSERT_EQ(partition_number(1000, 500), too_big);
+}
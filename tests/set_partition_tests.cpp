@@ -1,4 +1,5 @@
 #include "Discreture/SetPartitions.hpp"
+#include "common_tests.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
 #include <set>
@@ -79,3 +80,37 @@ TEST(SetPartitions, WithRangeNumParts)
         }
     }
 }
+
+TEST(SetPartitions, RandomIsUniform)
+{
+    for (int n = 1; n < 6; ++n)
+        test_random_is_uniform(set_partitions(n), 200);
+
+    test_random_is_uniform(set_partitions(6, 3), 100);
+    test_random_is_uniform(set_partitions(6, 2, 4), 50);
+
+    std::mt19937_64 engine(1);
+    check_set_partition(set_partitions(300).random(engine), 300);
+}
+
+TEST(SetPartitions, RandomWithHugeStirlingNumbers)
+{
+    // S(40,k) doesn't fit in an llint for any of these k. The number of blocks
+    // is 8, 9 or 10 with probability 0.0114, 0.1352 and 0.8529.
+    set_partitions X(40, 5, 10);
+    std::mt19937_64 engine(2);
+    const int num_samples = 4000;
+    std::vector<int> times(11, 0);
+    for (int i = 0; i < num_samples; ++i)
+    {
+        auto x = X.random(engine);
+        check_set_partition(x, 40);
+        ASSERT_GE(x.size(), 5);
+        ASSERT_LE(x.size(), 10);
+        ++times[x.size()];
+    }
+
+    EXPECT_NEAR(times[8]/double(num_samples), 0.0114, 0.01);
+    EXPECT_NEAR(times[9]/double(num_samples), 0.1352, 0.03);
+    EXPECT_NEAR(times[10]/double(num_samples), 0.8529, 0.03);
+}
@@ -0,0 +1,119 @@
+#include "Discreture/Combinations.hpp"
+#include "Discreture/SoAView.hpp"
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace discreture;
+
+struct Item
+{
+    double weight;
+    std::string name;
+    int value;
+};
+
+std::vector<Item> make_items(int n)
+{
+    std::vector<Item> items;
+    for (int i = 0; i < n; ++i)
+        items.push_back({0.5*i, "item" + std::to_string(i), i*i});
+    return items;
+}
+
+TEST(SoAView, Columns)
+{
+    auto items = make_items(10);
+    auto S = soa_view(items, &Item::value, &Item::weight);
+
+    ASSERT_EQ(S.size(), 10);
+    ASSERT_EQ(S.num_columns, 2);
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(S.column<0>()[i], items[i].value);
+        ASSERT_EQ(S.column<1>()[i], items[i].weight);
+        ASSERT_EQ(std::get<0>(S.record(i)), items[i].value);
+        ASSERT_EQ(std::get<1>(S.record(i)), items[i].weight);
+    }
+}
+
+TEST(SoAView, LanesOfCombinations)
+{
+    auto items = make_items(9);
+    auto S = soa_view(items, &Item::weight, &Item::value);
+
+    auto X = combinations(S, 4);
+    auto I = combinations(9, 4);
+    ASSERT_EQ(X.size(), I.size());
+
+    auto it = I.begin();
+    for (auto&& x : X)
+    {
+        auto w = lane<0>(x);
+        auto v = lane<1>(x);
+        ASSERT_EQ(w.size(), 4);
+
+        double total_weight = std::accumulate(w.begin(), w.end(), 0.0);
+        int total_value = std::accumulate(v.begin(), v.end(), 0);
+
+        double expected_weight = 0.0;
+        int expected_value = 0;
+        for (auto i : *it)
+        {
+            expected_weight += items[i].weight;
+            expected_value += items[i].value;
+        }
+
+        ASSERT_EQ(total_weight, expected_weight);
+        ASSERT_EQ(total_value, expected_value);
+
+        double gathered[4];
+        w.materialize_into(gathered);
+        for (int j = 0; j < 4; ++j)
+            ASSERT_EQ(gathered[j], items[(*it)[j]].weight);
+
+        ++it;
+    }
+}
+
+TEST(SoAView, IndexedViewOfRecords)
+{
+    auto items = make_items(8);
+    auto S = soa_view(items, &Item::value, &Item::weight);
+    ASSERT_EQ(std::get<0>(S[3]), items[3].value);
+
+    std::vector<int> chosen = {6, 1, 4};
+    auto x = indexed_view(S, chosen);
+    ASSERT_EQ(std::get<1>(x[2]), items[4].weight);
+
+    int j = 0;
+    for (auto&& r : x)
+    {
+        ASSERT_EQ(std::get<0>(r), items[chosen[j]].value);
+        ASSERT_EQ(std::get<1>(r), items[chosen[j]].weight);
+        ++j;
+    }
+    ASSERT_EQ(j, 3);
+
+    std::vector<std::tuple<int, double>> records(3);
+    x.materialize_into(records.begin());
+    ASSERT_EQ(records[1], std::make_tuple(items[1].value, items[1].weight));
+}
+
+TEST(SoAView, OwnedByTheContainer)
+{
+    auto items = make_items(6);
+    auto X = combinations(soa_view(items, &Item::value), 2);
+    items.clear();
+
+    int count = 0;
+    for (auto&& x : X)
+    {
+        auto v = lane<0>(x);
+        ASSERT_LT(v[0], v[1]);
+        ++count;
+    }
+    ASSERT_EQ(count, 15);
+}